@@ -0,0 +1,500 @@
+#ifndef ABI_H
+#define ABI_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+#include <web3cpp/devcore/Address.h>
+#include <web3cpp/devcore/Common.h>
+#include <web3cpp/devcore/CommonData.h>
+#include <web3cpp/devcore/FixedHash.h>
+#include <web3cpp/Utils.h>
+
+using json = nlohmann::ordered_json;
+
+/**
+ * Namespace for binary encoding/decoding of the
+ * [contract ABI](https://docs.soliditylang.org/en/latest/abi-spec.html).
+ * Works on raw bytes, converting to hex only at the edges, so it's the
+ * fast path behind Solidity::packMulti() and Contract.
+ */
+
+namespace ABI {
+  /**
+   * Descriptor of an ABI type. Recursive: arrays hold their element type,
+   * and tuples (structs) hold the type of each component.
+   */
+  struct Type {
+    /// The kinds of ABI types. Function is an external function reference (address + selector).
+    enum Kind { Uint, Int, Address, Bool, FixedBytes, Bytes, String, Array, Tuple, Function };
+
+    static constexpr size_t maxLength = 65536;         ///< The longest fixed array length accepted.
+    static constexpr size_t maxHeadSize = 32 * 65536;  ///< The largest head accepted for a static type, in bytes.
+
+    Kind kind = Uint;                 ///< The kind of the type.
+    unsigned int size = 256;          ///< Size in bits (Uint, Int) or bytes (FixedBytes, Function).
+    size_t length = 0;                ///< Array length. 0 for dynamic arrays (`T[]`).
+    std::vector<Type> components;     ///< Element type (Array, a single one) or component types (Tuple).
+    std::vector<std::string> names;   ///< Component names (Tuple). Empty strings for unnamed ones.
+
+    /**
+     * Parse a type.
+     * @param &type The type string (e.g. "uint8", "bytes32[2][]", "tuple[]"), or
+     *              a canonical tuple (e.g. "(uint256,bytes32)[]", no components needed).
+     * @param &components The "components" of a tuple type, as in the JSON ABI. Ignored otherwise.
+     * @param &out Set to the type.
+     * @return `true` on success, `false` if the type is invalid, not supported (fixed point numbers)
+     *         or too large (see maxLength and maxHeadSize).
+     */
+    static bool parse(const std::string& type, const json& components, Type& out);
+
+    /**
+     * Parse a parameter from a JSON ABI (a function's "inputs"/"outputs", an event's "inputs"...).
+     * @param &param The parameter, with "type" (and "components", for tuples).
+     * @param &out Set to the type.
+     * @return `true` on success, `false` otherwise.
+     */
+    static bool fromJson(const json& param, Type& out);
+
+    /**
+     * Parse a list of parameters from a JSON ABI.
+     * @param &params The parameters (a JSON array).
+     * @param &out Set to the types.
+     * @return `true` on success, `false` if any of them is invalid.
+     */
+    static bool fromJson(const json& params, std::vector<Type>& out);
+
+    /// Check if the type is dynamic (encoded in the tail, with an offset in the head).
+    bool isDynamic() const;
+
+    /// Get the size of the type in the head, in bytes.
+    size_t headSize() const;
+
+    /// Get the canonical name of the type, as used in signatures (e.g. "(uint256,bytes32)[]").
+    std::string canonical() const;
+  };
+
+  /**
+   * A function (or custom error) from a JSON ABI.
+   */
+  struct Function {
+    std::string name;           ///< The name of the function.
+    std::string signature;      ///< The canonical signature (e.g. "transfer(address,uint256)").
+    dev::bytes selector;        ///< The 4-byte selector.
+    std::vector<Type> inputs;   ///< The types of the arguments.
+    std::vector<Type> outputs;  ///< The types of the return values. Empty for errors.
+    size_t headSize = 0;        ///< Total size of the arguments' heads, in bytes.
+
+    /**
+     * Parse a function (or error) entry from a JSON ABI.
+     * @param &entry The entry, with "name", "inputs" and (optionally) "outputs".
+     * @param &out Set to the function.
+     * @return `true` on success, `false` if the entry or any of its types is invalid.
+     */
+    static bool fromJson(const json& entry, Function& out);
+  };
+
+  /**
+   * Decoder for ABI-encoded data (return values, revert data, log data).
+   * Works over a view of the data without copying it: typed reads return
+   * views into the data where possible (bytes, strings), and dynamic
+   * values are read through a Decoder over their own region.
+   * Every read is bounds-checked, so any data (even malicious) is safe to decode.
+   * Positions are byte offsets of a value's head in the decoder's region
+   * (the first value is at 0, the next one at `Type::headSize()` of the first...).
+   */
+  class Decoder {
+    private:
+      dev::bytesConstRef data;  ///< The encoded values: heads, then tails. Offsets are relative to its start.
+
+      /// Get the 32-byte word at a position, or `nullptr` if out of bounds.
+      const uint8_t* word(size_t pos) const;
+
+      /// Read a word as an offset or length, failing if it can't possibly be in bounds.
+      bool readSize(size_t pos, size_t& out) const;
+
+      /**
+       * Decode a sequence of values of the same type (array items), as a JSON array.
+       * @param &type The type of the items.
+       * @param count The number of items.
+       * @param &out Set to the items.
+       * @return `true` on success, `false` if the data is invalid.
+       */
+      bool decodeItems(const Type& type, size_t count, json& out) const;
+
+    public:
+      /// Empty constructor.
+      Decoder(){}
+
+      /**
+       * Constructor.
+       * @param _data The encoded data, without a selector. Has to outlive the decoder.
+       */
+      Decoder(dev::bytesConstRef _data) : data(_data) {}
+
+      /// Get the decoder's region.
+      dev::bytesConstRef region() const { return this->data; }
+
+      bool readUint(size_t pos, BigNumber& out) const;                      ///< Read a uint.
+      bool readInt(size_t pos, dev::s256& out) const;                       ///< Read an int.
+      bool readAddress(size_t pos, dev::Address& out) const;                ///< Read an address.
+      bool readBool(size_t pos, bool& out) const;                           ///< Read a bool.
+      bool readFixedBytes(size_t pos, size_t n, dev::bytesConstRef& out) const; ///< Read a bytesN (view).
+      bool readBytes(size_t pos, dev::bytesConstRef& out) const;            ///< Read a bytes (view).
+      bool readString(size_t pos, std::string_view& out) const;             ///< Read a string (view).
+
+      /**
+       * Enter a dynamic tuple (or a fixed-size array of dynamic items).
+       * @param pos The position of the value's head (its offset).
+       * @param &out Set to a decoder over the value's components.
+       * @return `true` on success, `false` if the data is invalid.
+       */
+      bool readTuple(size_t pos, Decoder& out) const;
+
+      /**
+       * Enter a dynamic array (`T[]`).
+       * @param pos The position of the value's head (its offset).
+       * @param &out Set to a decoder over the array's items.
+       * @param &length Set to the number of items.
+       * @return `true` on success, `false` if the data is invalid.
+       */
+      bool readArray(size_t pos, Decoder& out, size_t& length) const;
+
+      /**
+       * Decode a value as JSON, in the same format Solidity::packMulti()
+       * takes values: numbers, addresses and bools as strings (decimal, "0x"
+       * hex, "true"/"false"), bytes as "0x" hex, strings as text, and arrays
+       * and tuples as JSON arrays.
+       * @param &type The type of the value.
+       * @param pos The position of the value's head.
+       * @param &out Set to the value.
+       * @return `true` on success, `false` if the data is invalid.
+       */
+      bool decode(const Type& type, size_t pos, json& out) const;
+
+      /**
+       * Decode a list of values (e.g. a function's return values) as a JSON array.
+       * @param &types The types of the values, in order.
+       * @param &out Set to the values.
+       * @return `true` on success, `false` if the data is invalid.
+       */
+      bool decode(const std::vector<Type>& types, json& out) const;
+  };
+
+  /**
+   * Decode the data of a reverted call.
+   * Handles `Error(string)` (from `require`/`revert` with a reason),
+   * `Panic(uint256)` (from failed asserts, overflows...) and custom errors.
+   * @param data The revert data, selector included.
+   * @param &errors The custom errors that may be thrown (see Function::fromJson()).
+   * @param &out Set to the error, as `{"name", "signature", "args"}`
+   *             (e.g. `{"Error", "Error(string)", ["Not enough balance"]}`).
+   * @return `true` on success, `false` if the error is unknown or the data is invalid.
+   *         For known errors with invalid data, `out` still gets "name" and
+   *         "signature", but no "args"; for unknown ones it's left null.
+   */
+  bool decodeRevert(dev::bytesConstRef data, const std::vector<Function>& errors, json& out);
+
+  /**
+   * An event from a JSON ABI.
+   * Indexed parameters are stored in the log's topics (after topic0, the
+   * event's hash, unless the event is anonymous), and the rest are encoded
+   * in the log's data. Indexed dynamic values (bytes, strings, arrays,
+   * tuples) can't be recovered, only the hash of their encoding is stored.
+   */
+  struct Event {
+    std::string name;                 ///< The name of the event.
+    std::string signature;            ///< The canonical signature (e.g. "Transfer(address,address,uint256)").
+    dev::h256 topic;                  ///< The hash of the signature (topic0). Unused for anonymous events.
+    bool anonymous = false;           ///< If the event is anonymous (has no topic0).
+    std::vector<Type> inputs;         ///< The types of all the parameters, in order.
+    std::vector<std::string> names;   ///< The names of the parameters. Empty strings for unnamed ones.
+    std::vector<bool> indexed;        ///< If each parameter is indexed.
+    std::vector<Type> dataTypes;      ///< The types of the non-indexed parameters, in order.
+    size_t topicCount = 0;            ///< The number of topics in a log of this event, topic0 included.
+
+    /**
+     * Parse an event entry from a JSON ABI.
+     * @param &entry The entry, with "name", "inputs" (each with "indexed") and "anonymous".
+     * @param &out Set to the event.
+     * @return `true` on success, `false` if the entry or any of its types is invalid.
+     */
+    static bool fromJson(const json& entry, Event& out);
+
+    /**
+     * Decode a log of this event.
+     * @param &topics The log's topics.
+     * @param data The log's data.
+     * @param &out Set to the event, as `{"name", "signature", "args"}`, with
+     *             the args as a JSON array in the same format as Decoder::decode(),
+     *             and indexed dynamic values as their "0x" hex hash.
+     * @return `true` on success, `false` if the topics or data don't match the event.
+     */
+    bool decode(const std::vector<dev::h256>& topics, dev::bytesConstRef data, json& out) const;
+  };
+
+  /**
+   * Lookup table from topic0 to events, for dispatching logs to their event
+   * in constant time, no matter how many contracts and events are registered.
+   * The same event registered from several contracts (e.g. ERC-20's Transfer)
+   * is only stored once. Events with the same signature but different indexed
+   * parameters (e.g. ERC-20 and ERC-721's Transfer) are told apart by the
+   * number of topics in the log.
+   */
+  class EventRegistry {
+    private:
+      /// Events by topic0. Almost always a single one per topic.
+      std::unordered_map<dev::h256, std::vector<Event>> events;
+
+    public:
+      /**
+       * Register an event. Anonymous events are ignored, as they have no topic0.
+       * @param &event The event.
+       * @return `true` if the event was registered, `false` if it's anonymous
+       *         or already registered (same topic0 and indexed inputs).
+       */
+      bool add(const Event& event);
+
+      /**
+       * Register all the events from a JSON ABI.
+       * @param &abi The JSON ABI.
+       * @return The number of events registered. Invalid, anonymous and
+       *         already registered events aren't counted.
+       */
+      size_t add(const json& abi);
+
+      /// Get the number of registered events.
+      size_t size() const;
+
+      /**
+       * Find the event for a log.
+       * @param &topics The log's topics.
+       * @return The event, or `nullptr` if none matches.
+       */
+      const Event* find(const std::vector<dev::h256>& topics) const;
+
+      /**
+       * Decode a log.
+       * @param &topics The log's topics.
+       * @param data The log's data.
+       * @param &out Set to the event (see Event::decode()).
+       * @return `true` on success, `false` if the event is unknown or the data is invalid.
+       */
+      bool decode(const std::vector<dev::h256>& topics, dev::bytesConstRef data, json& out) const;
+
+      /**
+       * Decode a log, as returned by `eth_getLogs` or in a transaction receipt.
+       * @param &log The log, with "topics" and "data" as hex strings.
+       * @param &out Set to the event (see Event::decode()).
+       * @return `true` on success, `false` if the event is unknown or the log is invalid.
+       */
+      bool decode(const json& log, json& out) const;
+  };
+
+  /**
+   * Encoder for the arguments of a function call.
+   * Writes 32-byte words straight into a byte buffer: the head slot of each
+   * argument is reserved upfront, and dynamic data (bytes, strings, arrays)
+   * is appended after the heads, with its offset written back into the slot.
+   * The buffer can belong to the caller, so hot loops can reuse its memory.
+   * Arguments have to be added in order, and exactly as many as declared.
+   */
+  class Encoder {
+    private:
+      dev::bytes own;   ///< Buffer used when the caller doesn't provide one.
+      dev::bytes& out;  ///< The output buffer.
+      size_t base;      ///< Where the arguments start (after the selector).
+      size_t heads;     ///< Size of the head slots, in bytes (32 per argument, more for static tuples and arrays).
+      size_t next = 0;  ///< Offset of the next head slot to fill, relative to base.
+
+      /// Reset the buffer and reserve the selector and head slots.
+      void init(dev::bytesConstRef selector);
+
+      /// Get the next head slot. Out of range slots are ignored (see complete()).
+      uint8_t* head();
+
+      /// Append zeroed words to the buffer, returning where they start.
+      size_t grow(size_t words);
+
+      /// Get a pointer into the buffer.
+      uint8_t* at(size_t pos) { return out.data() + pos; }
+
+      /// Point the next head slot to the end of the buffer, where the data will be appended.
+      void headOffset();
+
+      /**
+       * Append a length-prefixed byte string to the buffer (`length, data`),
+       * right padded to a multiple of 32 bytes.
+       * @param data Pointer to the bytes.
+       * @param size Number of bytes.
+       */
+      void appendBlob(const uint8_t* data, size_t size);
+
+      /// Append a length-prefixed hex string (odd lengths get a leading zero), right padded.
+      void appendHexBlob(std::string_view hex);
+
+      /**
+       * Encode a value of any type. Static values are written in place;
+       * dynamic ones get an offset in place and their data appended.
+       * @param &type The type of the value.
+       * @param &value The value (see add()).
+       * @param pos Where the value's head goes in the buffer.
+       * @param start Where the enclosing tuple or array starts in the buffer
+       *              (offsets are relative to it).
+       * @param check If the value has to be checked as it's written (see addChecked()).
+       * @return The error code, or 0 on success. Always 0 if `check` isn't set.
+       */
+      uint64_t encode(const Type& type, const json& value, size_t pos, size_t start, bool check);
+
+      /**
+       * Encode a sequence of values (a tuple's components or an array's items)
+       * at the end of the buffer: their heads first, then their dynamic data.
+       * @param types The types of the values. A single one if `same` is set.
+       * @param &values The values, as a JSON array.
+       * @param same If every value has the same type (arrays).
+       * @param check If the values have to be checked as they're written.
+       * @return The error code of the first invalid value, or 0 on success.
+       */
+      uint64_t encodeSeq(const Type* types, const json& values, bool same, bool check);
+
+    public:
+      /**
+       * Constructor with an internal buffer.
+       * @param args The number of arguments.
+       * @param selector (optional) The 4-byte function selector written before the arguments.
+       */
+      Encoder(size_t args, dev::bytesConstRef selector = dev::bytesConstRef());
+
+      /**
+       * Constructor with a caller-owned buffer. The buffer is cleared, but
+       * keeps its capacity, so reusing it avoids allocations.
+       * @param &buffer The output buffer. Has to outlive the encoder.
+       * @param args The number of arguments.
+       * @param selector (optional) The 4-byte function selector written before the arguments.
+       */
+      Encoder(dev::bytes& buffer, size_t args, dev::bytesConstRef selector = dev::bytesConstRef());
+
+      /**
+       * Constructor with an internal buffer, for arguments of any type.
+       * @param &types The types of the arguments, in order.
+       * @param selector (optional) The 4-byte function selector written before the arguments.
+       */
+      Encoder(const std::vector<Type>& types, dev::bytesConstRef selector = dev::bytesConstRef());
+
+      /**
+       * Constructor with a caller-owned buffer, for arguments of any type.
+       * @param &buffer The output buffer. Has to outlive the encoder.
+       * @param &types The types of the arguments, in order.
+       * @param selector (optional) The 4-byte function selector written before the arguments.
+       */
+      Encoder(
+        dev::bytes& buffer, const std::vector<Type>& types,
+        dev::bytesConstRef selector = dev::bytesConstRef()
+      );
+
+      /**
+       * Constructor with a caller-owned buffer, for a call to a parsed function.
+       * Takes the selector and head size from the function, so nothing is computed per call.
+       * @param &buffer The output buffer. Has to outlive the encoder.
+       * @param &func The function. Arguments are added with its input types.
+       */
+      Encoder(dev::bytes& buffer, const Function& func);
+
+      Encoder(const Encoder&) = delete;             ///< Not copyable (may point to its own buffer).
+      Encoder& operator=(const Encoder&) = delete;  ///< Not copyable.
+
+      void addUint(const BigNumber& num);                           ///< Add a uint256.
+      void addAddress(const dev::Address& add);                     ///< Add an address.
+      void addBool(bool b);                                         ///< Add a bool.
+      void addBytes(dev::bytesConstRef data);                       ///< Add a bytes.
+      void addString(std::string_view str);                         ///< Add a string (UTF-8).
+      void addUintArray(const std::vector<BigNumber>& numV);        ///< Add a uint256[].
+      void addAddressArray(const std::vector<dev::Address>& addV);  ///< Add an address[].
+      void addBoolArray(const std::vector<bool>& bV);               ///< Add a bool[].
+      void addBytesArray(const std::vector<dev::bytes>& dataV);     ///< Add a bytes[].
+      void addStringArray(const std::vector<std::string>& strV);    ///< Add a string[].
+
+      /**
+       * Add an argument in the same format as Solidity::packMulti() takes it,
+       * parsing the strings straight into the buffer. Values are assumed to be
+       * valid (see Solidity::checkType()).
+       * @param &type The type (e.g. "uint256", "string[]").
+       * @param &value The value. Every value is a string (or an array of strings):
+       *               decimal numbers, hex addresses, "true"/"false"/"1"/"0",
+       *               hex bytes (with or without "0x") or UTF-8 text.
+       * @return `true` on success, `false` if the type is not supported.
+       */
+      bool add(const std::string& type, const json& value);
+
+      /**
+       * Add an argument of any type, in the same format Decoder::decode() returns it.
+       * Values are assumed to be valid (see Solidity::checkType()).
+       * @param &type The type.
+       * @param &value The value: strings for numbers (decimal, with a "-" for
+       *               negative ints), addresses, bools and bytes/bytesN (hex),
+       *               text for strings, and JSON arrays for arrays and tuples.
+       */
+      void add(const Type& type, const json& value);
+
+      /**
+       * Same as add(const Type&, const json&), but checks each value as it's
+       * written, instead of needing a separate pass with Solidity::checkType().
+       * Numbers are parsed once, range-checked and written.
+       * The buffer is left half-written if a value is invalid.
+       * @param &type The type.
+       * @param &value The value.
+       * @return The error code of the first invalid value (same as
+       *         Solidity::checkTypeCode()), or 0 on success.
+       */
+      uint64_t addChecked(const Type& type, const json& value);
+
+      /// Check if every declared argument was added.
+      bool complete() const { return this->next == this->heads; }
+
+      /// Get the encoded data (selector included).
+      const dev::bytes& data() const { return this->out; }
+
+      /// Get the encoded data as a "0x"-prefixed hex string.
+      std::string hex() const;
+  };
+
+  /**
+   * Parse a decimal number string. Digits are read 19 at a time, so most
+   * of the work is done with native 64-bit integers.
+   * @param num The number string. Non-digit characters are not checked.
+   * @return The number (wrapped around at 2^256, like a uint256).
+   */
+  BigNumber parseUint(std::string_view num);
+
+  /**
+   * Parse a decimal number string, checking that it fits in a given number of bits.
+   * @param num The number string. Only digits are accepted, and an empty one is 0.
+   * @param bits The size of the number, in bits (e.g. 8 for a uint8).
+   * @param &out Set to the number.
+   * @return `false` if the string isn't a number or the number doesn't fit.
+   */
+  bool parseUint(std::string_view num, unsigned int bits, BigNumber& out);
+
+  /**
+   * Check if a value is valid for a type, recursively.
+   * Numbers have to fit in the type's size, bytesN values in N bytes,
+   * and arrays and tuples have to be JSON arrays of the right length.
+   * @param &type The type.
+   * @param &value The value (see Encoder::add()).
+   * @return The error code, or 0 if the value is valid.
+   */
+  uint64_t check(const Type& type, const json& value);
+
+  /**
+   * Get the 4-byte selector of a function.
+   * @param func The full function signature (e.g. `foo(uint256,address[])`).
+   * @return The first 4 bytes of the Keccak-256 hash of the signature.
+   */
+  dev::bytes selector(const std::string& func);
+};
+
+#endif  // ABI_H
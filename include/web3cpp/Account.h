@@ -7,10 +7,14 @@
 #include <memory>
 
 #include <web3cpp/DB.h>
+#include <web3cpp/HistoryWriter.h>
 #include <web3cpp/Net.h>
+#include <web3cpp/NonceManager.h>
 #include <web3cpp/Provider.h>
 #include <web3cpp/Utils.h>
 #include <web3cpp/RPC.h>
+#include <web3cpp/TxIndex.h>
+#include <web3cpp/TxRecord.h>
 #include <nlohmann/json.hpp>
 #include <boost/filesystem.hpp>
 
@@ -26,17 +30,19 @@ class Account {
     std::string _address;                                        ///< Address for the account.
     std::string _name;                                           ///< Custom name/label for the account.
     std::string _derivationPath;                                 ///< Complete derivation path for the account (e.g. "m/44'/60'/0'/0").
-    uint64_t _nonce;                                             ///< Current nonce for the account.
     bool _isLedger;                                              ///< Indicates the account is imported from a Ledger device.
     const std::unique_ptr<Provider>& provider;                   ///< Pointer to Web3::defaultProvider.
     mutable std::mutex accountLock;                              ///< Mutex for managing read/write access to the account object.
-    Database transactionDB;                                      ///< Database of transactions made with the account.
+    Database transactionDB;                                      ///< Partition of the wallet's database with the account's transactions.
+    TxIndex _txIndex;                                            ///< Indexed view of transactionDB.
+    std::shared_ptr<NonceManager> _nonceManager;                 ///< Local nonce tracker for the account. Shared between copies.
+    std::shared_ptr<HistoryWriter> historyWriter;                ///< Write-behind queue for the history, if enabled. Accessed atomically.
 
   public:
   
     /**
-     * Default constructor.
-     * @param walletPath The path for the wallet from which the account comes from.
+     * Default constructor. Doesn't touch the network.
+     * @param &historyDB The partition of the wallet's database that holds the account's transactions.
      * @param name Custom name/label for the account.
      * @param __address Address for the account.
      * @param __derivationPath Full derivation path for the account (e.g. `m/44'/60'/0'/0`).
@@ -44,7 +50,7 @@ class Account {
      * @param *_provider Pointer to the provider used by the account.
      */
     Account(
-      const boost::filesystem::path& walletPath, const std::string& __address, const std::string& __name,
+      const Database& historyDB, const std::string& __address, const std::string& __name,
       const std::string& __derivationPath, bool __isLedger, const std::unique_ptr<Provider>& _provider
     );
 
@@ -54,9 +60,11 @@ class Account {
       _name(other._name),
       _derivationPath(other._derivationPath),
       _isLedger(other._isLedger),
-      _nonce(other._nonce),
       provider(other.provider),
-      transactionDB(other.transactionDB)
+      transactionDB(other.transactionDB),
+      _txIndex(other._txIndex),
+      _nonceManager(other._nonceManager),
+      historyWriter(std::atomic_load(&other.historyWriter))
     {}
     
     /// Copy constructor from pointer.
@@ -65,16 +73,27 @@ class Account {
       _name(other->_name),
       _derivationPath(other->_derivationPath),
       _isLedger(other->_isLedger),
-      _nonce(other->_nonce),
       provider(other->provider),
-      transactionDB(other->transactionDB)
+      transactionDB(other->transactionDB),
+      _txIndex(other->_txIndex),
+      _nonceManager(other->_nonceManager),
+      historyWriter(std::atomic_load(&other->historyWriter))
     {}
     
     const std::string& address()        const { return _address; }           ///< Getter for the address.
     const std::string& name()           const { return _name; }              ///< Getter for the custom name/label.
     const std::string& derivationPath() const { return _derivationPath; }    ///< Getter for the derivation path.
-    const uint64_t& nonce()             const { return _nonce; }             ///< Getter for the nonce.
     bool isLedger()                     const { return _isLedger; }          ///< Getter for the Ledger flag.
+    NonceManager& nonceManager()        const { return *_nonceManager; }     ///< Getter for the local nonce tracker.
+    const TxIndex& txIndex()            const { return _txIndex; }           ///< Getter for the indexed history (range queries by block, date, counterparty or status).
+
+    /**
+     * Get the account's next nonce, as tracked locally.
+     * Never makes a network request: sync it first with
+     * Wallet::refreshNonces() (or NonceManager::resync()).
+     * @return The next nonce, or the persisted one (or 0) if never synced.
+     */
+    uint64_t nonce() const;
 
     /**
      * Request the account's balance from the network.
@@ -82,18 +101,76 @@ class Account {
      */
     std::future<BigNumber> balance() const;
 
+    /**
+     * Set (or unset) the write-behind queue for the account's history.
+     * While set, saved transactions are only queued, and show up in the
+     * history once the queue writes them (see HistoryWriter::flush()).
+     * @param writer The queue, or `nullptr` to write synchronously.
+     */
+    void setHistoryWriter(std::shared_ptr<HistoryWriter> writer) { std::atomic_store(&historyWriter, writer); }
+
     /**
      * Save a transaction to the account's local history database.
+     * Stored as a compact TxRecord, so the sender is only recovered once,
+     * along with its index entries (see TxIndex).
      * @param signedTx The raw transaction signature that will be decoded and stored.
-     * @return `true` on success, `false` on failure.
+     * @return `true` on success (or when queued, in write-behind mode), `false` on failure.
      */
     bool saveTxToHistory(std::string signedTx);
 
+    /**
+     * Save many transactions to the account's local history database at once.
+     * Every transaction is written in a single atomic batch, so either all
+     * of them are saved or none are.
+     * @param &signedTxs The raw transaction signatures that will be decoded and stored.
+     * @return `true` on success, `false` on failure.
+     */
+    bool saveTxsToHistory(const std::vector<std::string>& signedTxs);
+
     /**
      * Get all saved transactions from this account's local history database.
+     * Internal keys (prefixed with "_", e.g. the nonce state and the indexes)
+     * are outside the scanned key ranges, so they're never read.
      * @return The account's transaction history as a JSON object.
      */
     json getTxHistory() const;
+
+    /**
+     * Get a page of saved transactions from this account's local history database.
+     * Only the page is read from the database, so histories of any size can be
+     * walked through with little memory. Transactions are ordered by hash.
+     * @param limit The maximum number of transactions in the page.
+     * @param &after The hash of the last transaction in the previous page,
+     *               or an empty string for the first page.
+     * @return The page as a JSON object. Empty when there are no more transactions.
+     */
+    json getTxHistory(uint64_t limit, const std::string& after = "") const;
+
+    /**
+     * Get a page of saved transactions as records, without building any JSON.
+     * Meant for queries over the history (e.g. filtering by status or date),
+     * which only need a few fields of each transaction.
+     * @param limit The maximum number of records in the page.
+     * @param &after The hash of the last transaction in the previous page,
+     *               or an empty string for the first page.
+     * @return The page, ordered by hash. Records that can't be read are skipped.
+     */
+    std::vector<TxRecord> getTxRecords(uint64_t limit, const std::string& after = "") const;
+
+    /**
+     * Mark a saved transaction as mined, updating its index entries.
+     * @param &hash The hash of the transaction, as stored in the history.
+     * @param blockNumber The block the transaction was mined in.
+     * @return `true` on success, `false` if the transaction isn't in the history or the write fails.
+     */
+    bool markTxConfirmed(const std::string& hash, uint64_t blockNumber);
+
+    /**
+     * Mark a saved transaction as rejected, updating its index entries.
+     * @param &hash The hash of the transaction, as stored in the history.
+     * @return `true` on success, `false` if the transaction isn't in the history or the write fails.
+     */
+    bool markTxInvalid(const std::string& hash);
 };
 
 #endif  // ACCOUNTS_H
@@ -0,0 +1,99 @@
+#ifndef BLOCKWATCHER_H
+#define BLOCKWATCHER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/Net.h>
+#include <web3cpp/Provider.h>
+#include <web3cpp/RPC.h>
+#include <web3cpp/Utils.h>
+
+using json = nlohmann::ordered_json;
+
+/**
+ * Polls the chain head on a single background thread and notifies
+ * subscribers whenever a new block shows up, so any number of
+ * block-driven consumers (e.g. ConfirmationTracker, FeeOracle) share
+ * one `eth_blockNumber` poll instead of each running their own loop.
+ * If several blocks are produced between two polls, subscribers are
+ * notified only once, with the most recent head.
+ */
+
+class BlockWatcher {
+  public:
+    /// Callback for new heads. Runs on the watcher thread, so it should be quick.
+    using Callback = std::function<void(uint64_t head)>;
+
+  private:
+    const std::unique_ptr<Provider>& provider;  ///< Pointer to Web3::defaultProvider.
+    unsigned int pollIntervalMs;                ///< Interval between head polls.
+    std::atomic<uint64_t> _head{0};             ///< Most recent head seen.
+    std::map<uint64_t, Callback> subscribers;   ///< Subscribed callbacks, per subscription id.
+    uint64_t nextSubId = 1;                     ///< Next subscription id to be handed out.
+    std::mutex subLock;                         ///< Mutex for managing read/write access to the subscribers.
+    std::recursive_mutex dispatchLock;          ///< Held while the head is updated and callbacks run, so unsubscribe() waits for them.
+    bool stopping = false;                      ///< Indicates the watcher is stopping.
+    std::mutex stopLock;                        ///< Mutex for the stop flag.
+    std::condition_variable stopCv;             ///< Wakes the poll thread up early when stopping.
+    std::thread pollThread;                     ///< Thread that runs pollLoop().
+
+    /// Threaded function that polls the head and notifies subscribers.
+    void pollLoop();
+
+    /**
+     * Request the current head from the network.
+     * @return The current block number, or 0 on failure.
+     */
+    uint64_t fetchHead();
+
+  public:
+    /**
+     * Constructor. Starts polling right away.
+     * @param *_provider Pointer to the provider that will be used.
+     * @param _pollIntervalMs (optional) Interval between head polls. Defaults to 1000ms.
+     */
+    BlockWatcher(const std::unique_ptr<Provider>& _provider, unsigned int _pollIntervalMs = 1000);
+
+    /// Destructor. Stops polling.
+    ~BlockWatcher();
+
+    const std::unique_ptr<Provider>& getProvider() const { return this->provider; } ///< Getter for the provider.
+
+    /// Get the most recent head seen, or 0 if none was seen yet.
+    uint64_t head() const { return this->_head; }
+
+    /**
+     * Report a head seen elsewhere (e.g. from a `newHeads` subscription),
+     * notifying subscribers on the calling thread if it's newer than the
+     * current one. Polled heads go through here too.
+     * @param newHead The block number of the head.
+     */
+    void notify(uint64_t newHead);
+
+    /**
+     * Subscribe to new heads.
+     * @param cb The callback to be called on each new head.
+     * @return The subscription id, to be used with unsubscribe().
+     */
+    uint64_t subscribe(Callback cb);
+
+    /**
+     * Unsubscribe from new heads. If the callback is running at the moment,
+     * waits for it to finish, so it's safe to destroy what it refers to afterwards.
+     * @param id The subscription id returned by subscribe().
+     */
+    void unsubscribe(uint64_t id);
+};
+
+#endif  // BLOCKWATCHER_H
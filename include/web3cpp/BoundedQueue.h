@@ -0,0 +1,101 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+/**
+ * Thread-safe FIFO queue with a fixed capacity.
+ * Producers block when the queue is full (backpressure) and consumers
+ * block when it's empty. Closing the queue wakes everyone up: producers
+ * stop being accepted and consumers drain whatever is left.
+ */
+
+template <typename T> class BoundedQueue {
+  private:
+    std::deque<T> items;                ///< Items currently in the queue.
+    std::size_t capacity;               ///< Maximum number of items in the queue.
+    bool closed = false;                ///< Indicates the queue doesn't accept new items anymore.
+    mutable std::mutex queueLock;       ///< Mutex for managing read/write access to the queue.
+    std::condition_variable notFull;    ///< Signaled when an item is removed or the queue is closed.
+    std::condition_variable notEmpty;   ///< Signaled when an item is added or the queue is closed.
+
+  public:
+    /**
+     * Constructor.
+     * @param _capacity The maximum number of items in the queue. 0 is treated as 1.
+     */
+    explicit BoundedQueue(std::size_t _capacity) : capacity((_capacity > 0) ? _capacity : 1) {}
+
+    /**
+     * Add an item to the end of the queue, blocking while the queue is full.
+     * @param item The item to add.
+     * @return `true` if the item was added, `false` if the queue was closed.
+     */
+    bool push(T item) {
+      std::unique_lock<std::mutex> lock(this->queueLock);
+      this->notFull.wait(lock, [this]{ return this->closed || this->items.size() < this->capacity; });
+      if (this->closed) return false;
+      this->items.push_back(std::move(item));
+      lock.unlock();
+      this->notEmpty.notify_one();
+      return true;
+    }
+
+    /**
+     * Take an item from the front of the queue, blocking while the queue is empty.
+     * @param &item The object that will receive the item.
+     * @return `true` if an item was taken, `false` if the queue was closed and is empty.
+     */
+    bool pop(T& item) {
+      std::unique_lock<std::mutex> lock(this->queueLock);
+      this->notEmpty.wait(lock, [this]{ return this->closed || !this->items.empty(); });
+      if (this->items.empty()) return false;
+      item = std::move(this->items.front());
+      this->items.pop_front();
+      lock.unlock();
+      this->notFull.notify_one();
+      return true;
+    }
+
+    /**
+     * Take an item from the front of the queue without blocking.
+     * @param &item The object that will receive the item.
+     * @return `true` if an item was taken, `false` if the queue is empty.
+     */
+    bool tryPop(T& item) {
+      std::unique_lock<std::mutex> lock(this->queueLock);
+      if (this->items.empty()) return false;
+      item = std::move(this->items.front());
+      this->items.pop_front();
+      lock.unlock();
+      this->notFull.notify_one();
+      return true;
+    }
+
+    /// Stop accepting new items and wake up every blocked producer/consumer.
+    void close() {
+      {
+        std::lock_guard<std::mutex> lock(this->queueLock);
+        this->closed = true;
+      }
+      this->notFull.notify_all();
+      this->notEmpty.notify_all();
+    }
+
+    /// Check if the queue was closed.
+    bool isClosed() const {
+      std::lock_guard<std::mutex> lock(this->queueLock);
+      return this->closed;
+    }
+
+    /// Get the number of items currently in the queue.
+    std::size_t size() const {
+      std::lock_guard<std::mutex> lock(this->queueLock);
+      return this->items.size();
+    }
+};
+
+#endif  // BOUNDEDQUEUE_H
@@ -0,0 +1,158 @@
+#ifndef CONFIRMATIONTRACKER_H
+#define CONFIRMATIONTRACKER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/BlockWatcher.h>
+#include <web3cpp/Contract.h>
+#include <web3cpp/Error.h>
+#include <web3cpp/Eth.h>
+#include <web3cpp/RPC.h>
+#include <web3cpp/TimerService.h>
+#include <web3cpp/Utils.h>
+
+using json = nlohmann::ordered_json;
+
+/**
+ * Waits for many transactions at once, driven by a BlockWatcher.
+ * On each new head, the receipts of every watched transaction are fetched
+ * in a single JSON-RPC batch, confirmations are counted against the head,
+ * and a receipt moving to another block (or disappearing) is treated as a
+ * reorg, which resets the count. Each watch is resolved exactly once,
+ * through both its future and its (optional) callback.
+ * The receipts are fetched on the tracker's own thread, so the watcher
+ * thread is never blocked by them (heads that show up in the meantime are
+ * merged into one check), and receipt timeouts are driven by TimerService,
+ * so they fire on time even if no new blocks show up.
+ */
+
+class ConfirmationTracker {
+  public:
+    /// Outcome of a watched transaction.
+    struct Status {
+      std::string hash;             ///< Transaction hash.
+      json receipt;                 ///< Transaction receipt (null if never mined).
+      uint64_t confirmations = 0;   ///< Confirmations when resolved (1 = mined on the head block).
+      unsigned int reorgs = 0;      ///< Times the receipt moved or disappeared while waiting.
+      uint64_t errorCode = 0;       ///< 0 on success, 37 on timeout, 38 if the transaction reverted.
+    };
+
+    /// Callback for resolved watches. Runs on the tracker's thread.
+    using Callback = std::function<void(const Status&)>;
+
+  private:
+    /// A single watched transaction.
+    struct Watch {
+      Status status;                                  ///< Current status.
+      unsigned int required = 1;                      ///< Confirmations required.
+      uint64_t mined = 0;                             ///< Block number of the receipt, if any.
+      std::chrono::steady_clock::time_point deadline; ///< When to give up waiting for a receipt.
+      TimerService::TimerId timer = 0;                ///< Timer that fires at the deadline.
+      std::promise<Status> promise;                   ///< Promise resolved when done.
+      Callback cb;                                    ///< Callback called when done.
+    };
+
+    BlockWatcher& watcher;              ///< Watcher that drives the polls.
+    Eth eth;                            ///< Eth object used for batched requests.
+    unsigned int defaultConfirmations;  ///< Confirmations required when none are given to watch().
+    unsigned int timeoutSec;            ///< Seconds to wait for a receipt.
+    unsigned int batchSize;             ///< Max receipts per batch.
+    uint64_t subId = 0;                 ///< Subscription id on the watcher.
+    std::map<uint64_t, std::shared_ptr<Watch>> watches; ///< Watched transactions, per watch id.
+    uint64_t nextWatchId = 0;           ///< Next watch id to be handed out.
+    uint64_t newHead = 0;               ///< Most recent head not checked yet (0 if none).
+    std::vector<uint64_t> expired;      ///< Watches whose deadline passed, not checked yet.
+    bool stopping = false;              ///< Indicates the tracker is stopping.
+    mutable std::mutex watchLock;       ///< Mutex for managing read/write access to the watches and the work above.
+    std::condition_variable workCv;     ///< Wakes the worker thread up when there's work to do.
+    std::thread worker;                 ///< Thread that runs workLoop().
+
+    /**
+     * Hand a new head over to the worker thread. Called on the watcher thread.
+     * @param head The new head.
+     */
+    void onHead(uint64_t head);
+
+    /// Threaded function that checks new heads and expired watches.
+    void workLoop();
+
+    /**
+     * Check every watched transaction against a new head.
+     * @param head The new head.
+     */
+    void check(uint64_t head);
+
+    /**
+     * Resolve watches whose deadline passed as timed out,
+     * unless a receipt was found for them in the meantime.
+     * @param &ids The ids of the watches to check.
+     */
+    void expire(const std::vector<uint64_t>& ids);
+
+    /**
+     * Remove a watch and resolve it, if it's still being watched.
+     * @param id The id of the watch.
+     * @param errorCode 0 on success, or the error code.
+     */
+    void finish(uint64_t id, uint64_t errorCode);
+
+    /**
+     * Resolve a watch through its future and callback.
+     * @param &w The watch to be resolved.
+     * @param errorCode 0 on success, or the error code.
+     */
+    void resolve(Watch& w, uint64_t errorCode);
+
+  public:
+    /**
+     * Constructor.
+     * @param &_watcher The watcher that will drive the polls.
+     * @param _defaultConfirmations (optional) Confirmations required. Defaults to 1.
+     * @param _timeoutSec (optional) Seconds to wait for a receipt. Defaults to 750.
+     * @param _batchSize (optional) Max receipts per batch. Defaults to 100.
+     */
+    ConfirmationTracker(
+      BlockWatcher& _watcher, unsigned int _defaultConfirmations = 1,
+      unsigned int _timeoutSec = 750, unsigned int _batchSize = 100
+    );
+
+    /**
+     * Constructor using a contract's transaction options
+     * (`transactionConfirmationBlocks` and `transactionPollingTimeout`).
+     * @param &_watcher The watcher that will drive the polls.
+     * @param &opts The contract's options.
+     */
+    ConfirmationTracker(BlockWatcher& _watcher, const Contract::Options& opts);
+
+    /// Destructor. Pending watches are resolved as timed out.
+    ~ConfirmationTracker();
+
+    /**
+     * Watch a transaction until it's confirmed, reverted or timed out.
+     * @param hash The transaction hash.
+     * @param cb (optional) Callback called when resolved.
+     * @param confirmations (optional) Confirmations required.
+     *                      Defaults to 0 (use the tracker's default).
+     * @return A future resolved with the transaction's final status.
+     */
+    std::future<Status> watch(
+      const std::string& hash, Callback cb = nullptr, unsigned int confirmations = 0
+    );
+
+    /// Get the number of transactions still being watched.
+    std::size_t pending() const;
+};
+
+#endif  // CONFIRMATIONTRACKER_H
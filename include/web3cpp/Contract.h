@@ -2,6 +2,7 @@
 #define CONTRACT_H
 
 #include <future>
+#include <memory>
 #include <string>
 #include <vector>
 #include <web3cpp/devcore/Common.h>
@@ -10,6 +11,7 @@
 #include <web3cpp/ethcore/KeyManager.h>
 #include <web3cpp/ethcore/TransactionBase.h>
 
+#include <web3cpp/ABI.h>
 #include <web3cpp/Utils.h>
 #include <web3cpp/Error.h>
 #include <web3cpp/Solidity.h>
@@ -19,7 +21,8 @@ using json = nlohmann::ordered_json;
 
 // TODO:
 // - Implement promievents to deal with those functions:
-//   - once(), events(), allEvents(), getPastEvents()
+//   - once(), allEvents(), getPastEvents()
+//   (the logs they return can already be decoded with decodeLog())
 
 /**
  * Abstraction of a single smart contract.
@@ -27,7 +30,7 @@ using json = nlohmann::ordered_json;
 
 class Contract {
   private:
-    /// Enum for parsing Solidity variable types.
+    /// Enum for the legacy Solidity variable types. Only used to list methods().
     enum Types {
       uint256, uint256Arr,
       address, addressArr,
@@ -36,16 +39,10 @@ class Contract {
       string, stringArr
     };
 
-    /**
-     * Check if a given type is an array.
-     * @param &type Type value that will be checked.
-     * @return `true` if type is array, `false` otherwise.
-     */
-    bool isTypeArray(Types const &type);
-
     /**
      * List of methods from the contract, as key and value pairs.
      * Key is the method name, value is a vector with each of the method's parameter types.
+     * Only methods whose parameters all have legacy types are listed.
      */
     std::map<std::string,std::vector<Types>> _methods;
 
@@ -55,6 +52,21 @@ class Contract {
      */
     std::map<std::string,std::string> _functors;
 
+    /**
+     * Parsed functions from the contract, used for encoding their arguments and decoding their return values.
+     * Never modified after parsing, so copies of the contract and its Method handles share them.
+     */
+    std::map<std::string,std::shared_ptr<const ABI::Function>> _functions;
+
+    /// Parsed custom errors from the contract, used for decoding revert data.
+    std::vector<ABI::Function> _errors;
+
+    /// Parsed events from the contract. Key is the event name.
+    std::map<std::string,ABI::Event> _events;
+
+    /// Lookup table for dispatching logs to their events by topic0.
+    ABI::EventRegistry _eventRegistry;
+
   public:
     /// Transaction options for the contract.
     class Options {
@@ -73,6 +85,62 @@ class Contract {
         std::string hardfork;                       ///< Hardfork used for transactions. Defaults to "fuji".
     };
 
+    /**
+     * Handle to one of the contract's functions, from fn().
+     * Holds the function's encoding plan (selector, head size and argument
+     * types, all parsed once with the contract), so calls through it skip the
+     * name lookup and go straight to checking and writing the arguments.
+     * Shares the parsed function with the contract, so it stays valid after
+     * the contract is copied or destroyed.
+     */
+    class Method {
+      private:
+        std::shared_ptr<const ABI::Function> func;  ///< The parsed function. Null if not found.
+
+      public:
+        /// Empty constructor. Creates an invalid handle.
+        Method(){}
+
+        /**
+         * Constructor.
+         * @param _func The parsed function.
+         */
+        Method(std::shared_ptr<const ABI::Function> _func) : func(std::move(_func)) {}
+
+        /// Check if the handle points to a function.
+        bool valid() const { return this->func != nullptr; }
+
+        /// Get the parsed function. The handle has to be valid.
+        const ABI::Function& function() const { return *this->func; }
+
+        /**
+         * Encode a call to the function into a buffer.
+         * Reusing the same buffer across calls avoids allocating for each one.
+         * @param &arguments The function's arguments as a JSON array (see operator()).
+         * @param &buffer The output buffer, overwritten with the encoded call.
+         *                Cleared (keeping its capacity) if an argument is invalid.
+         * @param &error Error object.
+         * @return `true` on success, `false` otherwise.
+         */
+        bool encode(const json& arguments, dev::bytes& buffer, Error &error) const;
+
+        /**
+         * Encode a call to the function.
+         * @param &arguments The function's arguments as a JSON array (see operator()).
+         * @param &error Error object.
+         * @return The encoded call as a "0x" hex string, or an empty string on failure.
+         */
+        std::string operator() (const json& arguments, Error &error) const;
+
+        /**
+         * Decode the function's return data.
+         * @param &data The returned data, as a hex string.
+         * @param &error Error object.
+         * @return A JSON array with the decoded values, or an empty JSON on failure.
+         */
+        json decodeOutput(const std::string& data, Error &error) const;
+    };
+
     /**
      * Constructor.
      * @param jsonInterface The contract ABI as a JSON object.
@@ -87,6 +155,8 @@ class Contract {
     /**
      * List of methods from the contract, as key and value pairs.
      * Key is the method name, value is a vector with each of the method's parameter types.
+     * Only methods whose parameters all have legacy types are listed
+     * (see fn() for the others).
      */
     const std::map<std::string,std::vector<Types>>& methods() { return _methods; }
 
@@ -96,6 +166,26 @@ class Contract {
      */
     const std::map<std::string,std::string>& functors() { return _functors; };
 
+    /**
+     * List of events from the contract.
+     * Key is the event name, value is the parsed event.
+     */
+    const std::map<std::string,ABI::Event>& events() { return _events; }
+
+    /**
+     * Lookup table with the contract's events. Other contracts' events can be
+     * added to it (see ABI::EventRegistry::add()) to decode logs from all of them at once.
+     */
+    const ABI::EventRegistry& eventRegistry() { return _eventRegistry; }
+
+    /**
+     * Get a handle to one of the contract's functions, for encoding calls
+     * to it repeatedly. e.g. `contract.fn("transfer")(args, error)`.
+     * @param function The function's name.
+     * @return The handle. Invalid if the function doesn't exist or has unsupported types.
+     */
+    Method fn(const std::string& function) const;
+
     /**
      * Clones the current contract instance.
      * @return The cloned contract object.
@@ -103,11 +193,11 @@ class Contract {
     Contract clone();
 
     /**
-     * ABI constructor. Uses the custom Solidity class.
+     * ABI constructor. Encodes a call with the function's parsed ABI (see fn()).
      * **Pay attention to the arg order! "args, func" = this one.**
-     * @param arguments The function's arguments as a JSON object,
-     *                      each with "type" and "value" (or "t" and "v").
-     *                      e.g. `{{"t", "string"}, {"v", "Hello!%"}}`
+     * @param arguments The function's arguments as a JSON array of values,
+     *                  e.g. `["5123815123858123", ["0xaaaa...", "0xbbbb..."]]`
+     *                  (see ABI::Encoder::add()).
      * @param function The function's name.
      * @param &error Error object.
      * @return The %Solidity encoded function ABI.
@@ -115,18 +205,47 @@ class Contract {
     std::string operator() (const json& arguments, const std::string& function, Error &error);
 
     /**
-     * ABI constructor.
-     * **LEGACY/UNMAINTAINED**
-     * Use only if the normal one doesn't work as intended for some reason.
+     * ABI constructor. Same as the "args, func" one, kept for compatibility.
      * **Pay attention to the arg order! "func, args" = this one.**
      * @param function The function's name.
-     * @param arguments The function's arguments as a JSON object,
-     *                      each with "type" and "value" (or "t" and "v").
-     *                      e.g. `{{"t", "string"}, {"v", "Hello!%"}}`
+     * @param arguments The function's arguments as a JSON array of values,
+     *                  e.g. `["5123815123858123", ["0xaaaa...", "0xbbbb..."]]`
+     *                  (see ABI::Encoder::add()).
      * @param &error Error object.
      * @return The %Solidity encoded function ABI.
      */
     std::string operator() (const std::string& function, const json& arguments, Error &error);
+
+    /**
+     * Decode the return data of a function call (e.g. from `eth_call`).
+     * @param function The function's name.
+     * @param data The returned data, as a hex string.
+     * @param &error Error object.
+     * @return A JSON array with the decoded values, in the same format as the
+     *         arguments (e.g. `["5123815123858123", "0xaaaaaaaaaaaaaaa..."]`),
+     *         or an empty JSON on failure.
+     */
+    json decodeOutput(const std::string& function, const std::string& data, Error &error);
+
+    /**
+     * Decode the revert data of a failed call or transaction.
+     * Handles `Error(string)`, `Panic(uint256)` and the contract's custom errors.
+     * @param data The revert data, as a hex string.
+     * @param &error Error object.
+     * @return A JSON object with "name", "signature" and "args" (a JSON array),
+     *         or an empty JSON on failure.
+     */
+    json decodeRevert(const std::string& data, Error &error);
+
+    /**
+     * Decode a log emitted by the contract.
+     * @param &log The log, as returned by `eth_getLogs` or in a transaction
+     *             receipt (only "topics" and "data" are used).
+     * @param &error Error object.
+     * @return A JSON object with "name", "signature" and "args" (a JSON array,
+     *         with indexed dynamic values as their hash), or an empty JSON on failure.
+     */
+    json decodeLog(const json& log, Error &error);
 };
 
 #endif  // CONTRACT_H
@@ -2,27 +2,38 @@
 #define DATABASE_H
 
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <nlohmann/json.hpp>
 #include <boost/filesystem.hpp>
-#include <leveldb/db.h>
+
+#include <web3cpp/DBBackend.h>
 
 using json = nlohmann::ordered_json;
 
 /**
- * Abstraction of a single [LevelDB](https://github.com/google/leveldb) database.
+ * Abstraction of a single key/value database.
+ * Backed by a [LevelDB](https://github.com/google/leveldb) database by
+ * default, or by any other DBBackend (e.g. inMemory() or openTable()).
+ * A database can be split into partitions, which share the same engine
+ * and keep their keys under a common prefix. Copies (and partitions)
+ * are cheap, and the database is closed once the last one is destroyed.
+ * Engines are thread-safe on their own, so no operation takes a lock here:
+ * every call works on its own buffers.
  */
 
 class Database {
   private:
     std::string name;             ///< Name for the database.
     boost::filesystem::path path; ///< Full path for the database (includes name).
-    leveldb::DB* db = nullptr;     ///< Pointer to the actual LevelDB database object.
-    leveldb::Options dbOpts;      ///< Struct with options for the database.
-    leveldb::Status dbStatus;     ///< Struct with the status of the last database operation.
-    std::string tmpValue;         ///< Buffer for a temporary value.
-    std::mutex mutable dbMutex;   ///< Mutex for managing read/write access to the database.
+    std::shared_ptr<DBBackend> db; ///< Shared handle to the storage engine.
+    std::string prefix;           ///< Prefix for every key in this partition. Empty for the whole database.
+    std::shared_ptr<const DBBackend::Snapshot> snap; ///< Snapshot that reads are pinned to, if any.
+    DatabaseOptions options;      ///< Struct with options for the database.
 
     /**
      * Opens the proper database object.
@@ -32,12 +43,35 @@ class Database {
 
     /**
      * Closes the proper database object.
-     * "Closing" a LevelDB database actually means just deleting the database object.
+     * The engine itself is closed once no copy or partition uses it anymore.
      * @return `true` on success, `false` on failure.
      */
     bool closeDB();
 
+    /**
+     * Apply writes through the engine, logging any failure.
+     * @param &writes The writes, with full keys.
+     * @param sync If `true`, waits until the writes are durable.
+     * @return `true` on success, `false` on failure.
+     */
+    bool write(const std::vector<DBBackend::Write>& writes, bool sync);
+
+    /// Get the full key for a key in this partition.
+    std::string fullKey(const std::string& key) const { return prefix + key; }
+
   public:
+    class Batch;
+    class Cursor;
+
+    /// Bounds for a Cursor. Keys are relative to the database (or partition).
+    struct Range {
+      std::string prefix;   ///< Only keys starting with this prefix.
+      std::string start;    ///< Only keys greater than or equal to this one. Empty means no bound.
+      std::string end;      ///< Only keys less than this one. Empty means no bound.
+      bool reverse = false; ///< Iterate from the last key to the first one.
+      uint64_t limit = 0;   ///< Stop after this many entries. 0 means no limit.
+    };
+
     /// Empty constructor.
     Database(){}
 
@@ -45,24 +79,92 @@ class Database {
      * Default constructor.
      * @param _name The database's name.
      * @param rootPath The parent folder of the database.
+     * @param _options The tuning options for the database.
      */
-    Database(const std::string& _name, const boost::filesystem::path& rootPath)
-    : name(_name), path(rootPath.string() + "/" + name) {
-      this->dbOpts.create_if_missing = true;
+    Database(
+      const std::string& _name, const boost::filesystem::path& rootPath,
+      const DatabaseOptions& _options = DatabaseOptions()
+    ) : name(_name), path(rootPath.string() + "/" + name), options(_options) {
       openDB();
     }
 
-    /// Copy constructor.
+    /**
+     * Constructor for a database on a custom engine.
+     * @param _db The engine.
+     * @param &_name The database's name, for logging.
+     */
+    Database(std::shared_ptr<DBBackend> _db, const std::string& _name)
+      : name(_name), db(std::move(_db)) {}
+
+    /**
+     * Create an empty database that lives only in memory.
+     * Meant for tests and ephemeral caches.
+     * @param &_name The database's name, for logging.
+     * @return The database.
+     */
+    static Database inMemory(const std::string& _name = "memory");
+
+    /**
+     * Open a read-only table file (see TableBackend), mapped into memory.
+     * Every write to it fails.
+     * @param &file The path of the table file.
+     * @return The database. Not open (see isOpen()) if the file isn't a valid table.
+     */
+    static Database openTable(const boost::filesystem::path& file);
+
+    /**
+     * Write every entry of the database (or partition) to a table file,
+     * which can then be opened with openTable().
+     * @param &file The path of the table file. Overwritten if it exists.
+     * @return `true` on success, `false` on failure.
+     */
+    bool exportTable(const boost::filesystem::path& file) const;
+
+    /// Copy constructor. Shares the same engine.
     Database(const Database& other) noexcept :
-      name(other.name), path(other.path), db(other.db),
-      dbOpts(other.dbOpts), dbStatus(other.dbStatus), tmpValue(other.tmpValue)
+      name(other.name), path(other.path), db(other.db), prefix(other.prefix),
+      snap(other.snap), options(other.options)
     {}
 
-    /// Destructor.
+    /// Move constructor.
+    Database(Database&& other) noexcept = default;
+
+    /// Copy assignment. Shares the other database's engine.
+    Database& operator=(const Database& other) = default;
+
+    /// Move assignment.
+    Database& operator=(Database&& other) noexcept = default;
+
+    /// Destructor. The engine is closed when the last copy is gone.
     ~Database() { closeDB(); }
 
     /**
-     * Check if a key exists in the database.
+     * Get a partition of the database.
+     * Keys in the partition are stored as `prefix + key`, and every
+     * operation on the partition only sees its own keys (without the prefix).
+     * @param &_prefix The prefix for the partition (e.g. "accounts/").
+     *                 Nested partitions stack their prefixes.
+     * @return The partition, sharing this database's engine.
+     */
+    Database partition(const std::string& _prefix) const;
+
+    /**
+     * Get a read-consistent view of the database (or partition).
+     * Every read through the view (lookups, cursors, getAll*()) sees the
+     * database exactly as it was when the view was taken, no matter what
+     * is written afterwards. Writes through the view go to the live database.
+     * @return The view, sharing this database's engine.
+     */
+    Database snapshot() const;
+
+    /// Getter for the options the database was opened with.
+    const DatabaseOptions& getOptions() const { return this->options; }
+
+    /// Check if the database was opened successfully.
+    bool isOpen() const { return this->db != nullptr; }
+
+    /**
+     * Check if a key exists in the database. This is a single point lookup.
      * @param &key The key to search for.
      * @return `true` if the key exists, `false` otherwise.
      */
@@ -71,9 +173,20 @@ class Database {
     /**
      * Get the value of a key from the database.
      * @param &key The key to get the value from.
-     * @return The value linked to the given key.
+     * @return The value linked to the given key, or an empty string if
+     *         the key doesn't exist.
+     */
+    std::string getKeyValue(std::string const &key) const;
+
+    /**
+     * Get the value of a key from the database into a caller-owned buffer.
+     * Tells a missing key apart from an empty value, and lets hot loops
+     * reuse the same buffer.
+     * @param &key The key to get the value from.
+     * @param &value The buffer the value is written to. Untouched if the key doesn't exist.
+     * @return `true` if the key exists, `false` otherwise.
      */
-    std::string getKeyValue(std::string const &key);
+    bool getKeyValue(std::string const &key, std::string &value) const;
 
     /**
      * Insert a key/value pair into the database.
@@ -91,6 +204,20 @@ class Database {
      */
     bool deleteKeyValue(std::string const &key);
 
+    /**
+     * Start iterating over every key in the database (or partition), in order.
+     * @return A cursor at the first key.
+     */
+    Cursor cursor() const;
+
+    /**
+     * Start iterating over a range of keys. Entries are read as the cursor
+     * moves, so scans of any size only keep one entry in memory.
+     * @param &range The bounds for the iteration.
+     * @return A cursor at the first key in the range.
+     */
+    Cursor cursor(const Range& range) const;
+
     /**
      * Get all the individual keys stored in the database.
      * @return A vector with all the key strings.
@@ -109,8 +236,127 @@ class Database {
      */
     std::map<std::string, std::string> getAllPairs() const;
 
-    /// Clear all entries stored in the database.
-    void dropDatabase();
+    /**
+     * Start a write batch on the database (or partition).
+     * Nothing is written until the batch is committed.
+     * @return An empty batch.
+     */
+    Batch batch() const;
+
+    /**
+     * Clear all entries stored in the database (or in the partition).
+     * Done as a single atomic write.
+     * @return `true` on success, `false` on failure.
+     */
+    bool dropDatabase();
+};
+
+/**
+ * A group of writes that are applied atomically, with a single log write.
+ * Keys are relative to the database (or partition) the batch came from,
+ * but writes can also target other partitions of the same database,
+ * so related keys in different partitions are updated together.
+ * A batch that is destroyed without being committed is rolled back.
+ */
+class Database::Batch {
+  private:
+    Database owner;                        ///< The database (or partition) the batch came from.
+    std::vector<DBBackend::Write> writes;  ///< The pending writes, with full keys.
+
+  public:
+    /**
+     * Constructor. Use Database::batch() instead.
+     * @param &_owner The database (or partition) the batch writes to.
+     */
+    Batch(const Database& _owner) : owner(_owner) {}
+
+    /**
+     * Queue a key/value insertion.
+     * @param &key The key to insert.
+     * @param &value The value to insert under the given key.
+     */
+    void put(const std::string& key, const std::string& value);
+
+    /**
+     * Queue a key/value insertion on another partition of the same database.
+     * @param &part The partition to insert into.
+     * @param &key The key to insert.
+     * @param &value The value to insert under the given key.
+     * @return `true` if queued, `false` if the partition belongs to another database.
+     */
+    bool put(const Database& part, const std::string& key, const std::string& value);
+
+    /**
+     * Queue a key/value deletion.
+     * @param &key The key to delete.
+     */
+    void del(const std::string& key);
+
+    /**
+     * Queue a key/value deletion on another partition of the same database.
+     * @param &part The partition to delete from.
+     * @param &key The key to delete.
+     * @return `true` if queued, `false` if the partition belongs to another database.
+     */
+    bool del(const Database& part, const std::string& key);
+
+    /// Get the number of pending writes.
+    uint64_t size() const { return this->writes.size(); }
+
+    /**
+     * Apply every pending write at once. The batch is empty afterwards.
+     * @param sync If `true`, waits until the writes are flushed to disk,
+     *             so they survive a machine crash (not just a process crash).
+     *             An empty batch with `sync` flushes earlier writes.
+     * @return `true` on success, `false` on failure (nothing is applied).
+     */
+    bool commit(bool sync = false);
+
+    /// Drop every pending write.
+    void rollback() { this->writes.clear(); }
+};
+
+/**
+ * Forward or reverse iterator over a range of keys.
+ * The cursor sees a consistent view of the database, as it was when the
+ * cursor was created (or when the snapshot it came from was taken).
+ * Keys and values are views into the underlying iterator, so they're
+ * only valid until the cursor moves.
+ */
+class Database::Cursor {
+  private:
+    std::shared_ptr<DBBackend> db;                 ///< Engine being iterated.
+    std::shared_ptr<const DBBackend::Snapshot> snap; ///< Snapshot being iterated, if any.
+    std::unique_ptr<DBBackend::Iterator> it;       ///< The underlying iterator. Destroyed first.
+    size_t stripSize;                              ///< Size of the partition prefix, stripped from keys.
+    std::string lower;                             ///< Lowest full key allowed (inclusive).
+    std::string upper;                             ///< Highest full key allowed (exclusive). Empty means no bound.
+    bool reverse;                                  ///< Iterating from the last key to the first one.
+    uint64_t remaining;                            ///< Entries left before the limit. 0 means no limit.
+    bool limited;                                  ///< Indicates a limit was set.
+
+    /// Check if the iterator is within the bounds.
+    bool inRange() const;
+
+  public:
+    /**
+     * Constructor. Use Database::cursor() instead.
+     * @param &_db The database (or partition) to iterate over.
+     * @param &range The bounds for the iteration.
+     */
+    Cursor(const Database& _db, const Range& range);
+
+    /// Check if the cursor points to an entry. `false` once the range is over.
+    bool valid() const;
+
+    /// Move to the next entry (the previous one, for reverse cursors).
+    void next();
+
+    /// Get the key of the current entry, without the partition prefix.
+    std::string_view key() const;
+
+    /// Get the value of the current entry.
+    std::string_view value() const;
 };
 
 #endif  // DATABASE_H
@@ -0,0 +1,263 @@
+#ifndef DBBACKEND_H
+#define DBBACKEND_H
+
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <leveldb/cache.h>
+#include <leveldb/db.h>
+#include <leveldb/filter_policy.h>
+#include <leveldb/write_batch.h>
+
+/**
+ * Tuning options for a LevelDB-backed Database.
+ * The defaults match LevelDB's own, plus a bloom filter. Use the presets
+ * as a starting point for databases with a known workload.
+ */
+struct DatabaseOptions {
+  size_t cacheSize = 8 << 20;             ///< Size of the LRU block cache in bytes. Ignored if `cache` is set.
+  std::shared_ptr<leveldb::Cache> cache;  ///< Block cache shared with other databases (see sharedCache()).
+  int bloomBitsPerKey = 10;               ///< Bits per key of the bloom filter (10 gives ~1% false positives). 0 disables it.
+  bool compression = true;                ///< Compress blocks with Snappy.
+  size_t writeBufferSize = 4 << 20;       ///< Size of the in-memory write buffer before it's written to disk.
+  int maxOpenFiles = 1000;                ///< Maximum number of open files (table files are kept open for reads).
+  bool paranoidChecks = false;            ///< Check data aggressively, stopping early on any corruption.
+
+  /**
+   * Preset for databases mostly read at random (e.g. receipt caches):
+   * a big block cache and more open table files.
+   */
+  static DatabaseOptions readHeavy();
+
+  /**
+   * Preset for databases mostly written to (e.g. bulk imports):
+   * a big write buffer, so fewer and larger table files are written.
+   */
+  static DatabaseOptions writeHeavy();
+
+  /**
+   * Create an LRU block cache that can be shared by many databases,
+   * so they're bound by a single memory budget.
+   * @param capacity The size of the cache in bytes.
+   * @return The cache.
+   */
+  static std::shared_ptr<leveldb::Cache> sharedCache(size_t capacity);
+};
+
+/**
+ * Storage engine interface behind a Database.
+ * Engines only deal with full keys: partitions, batches and cursor bounds
+ * are all handled by Database on top of this. Every engine must be safe
+ * to use from many threads at once.
+ */
+
+class DBBackend : public std::enable_shared_from_this<DBBackend> {
+  public:
+    /// A single write, as part of an atomic group of writes.
+    struct Write {
+      bool erase;         ///< `true` for a deletion, `false` for an insertion.
+      std::string key;    ///< The key to write.
+      std::string value;  ///< The value to insert. Unused for deletions.
+    };
+
+    /// A point-in-time view of the engine. Released when destroyed.
+    class Snapshot {
+      public:
+        virtual ~Snapshot() = default;  ///< Destructor.
+    };
+
+    /**
+     * Ordered iterator over the engine's keys.
+     * Sees a consistent view of the engine, as it was when it was created.
+     * Keys and values are only valid until the iterator moves.
+     */
+    class Iterator {
+      public:
+        virtual ~Iterator() = default;                  ///< Destructor.
+        virtual bool valid() const = 0;                 ///< Check if the iterator points to an entry.
+        virtual void seekToFirst() = 0;                 ///< Move to the first key.
+        virtual void seekToLast() = 0;                  ///< Move to the last key.
+        virtual void seek(std::string_view key) = 0;    ///< Move to the first key greater than or equal to `key`.
+        virtual void next() = 0;                        ///< Move to the next key.
+        virtual void prev() = 0;                        ///< Move to the previous key. Invalid if there's none.
+        virtual std::string_view key() const = 0;       ///< Get the current key.
+        virtual std::string_view value() const = 0;     ///< Get the current value.
+    };
+
+    virtual ~DBBackend() = default;  ///< Destructor.
+
+    /**
+     * Get the value of a key.
+     * @param &key The key to get the value from.
+     * @param &value The buffer the value is written to. Untouched if the key doesn't exist.
+     * @param *snap The snapshot to read from, or `nullptr` for the live data.
+     * @return `true` if the key exists, `false` otherwise.
+     */
+    virtual bool get(const std::string& key, std::string& value, const Snapshot* snap) const = 0;
+
+    /**
+     * Apply a group of writes atomically.
+     * @param &writes The writes, applied in order.
+     * @param sync If `true`, waits until the writes are durable.
+     * @param &error Set to the reason on failure.
+     * @return `true` on success, `false` on failure (nothing is applied).
+     */
+    virtual bool write(const std::vector<Write>& writes, bool sync, std::string& error) = 0;
+
+    /**
+     * Create an iterator, positioned nowhere (call a seek first).
+     * @param *snap The snapshot to iterate over, or `nullptr` for the live data.
+     * @return The iterator.
+     */
+    virtual std::unique_ptr<Iterator> iterator(const Snapshot* snap) const = 0;
+
+    /// Take a snapshot of the engine.
+    virtual std::shared_ptr<const Snapshot> snapshot() const = 0;
+};
+
+/// The default engine, a [LevelDB](https://github.com/google/leveldb) database on disk.
+class LevelDBBackend : public DBBackend {
+  private:
+    std::shared_ptr<leveldb::Cache> cache;          ///< Block cache. Has to outlive db.
+    std::unique_ptr<const leveldb::FilterPolicy> filter; ///< Bloom filter policy. Has to outlive db.
+    std::unique_ptr<leveldb::DB> db;                ///< The LevelDB database object. Declared last, so it's destroyed first.
+
+    class LevelDBSnapshot;
+    class LevelDBIterator;
+
+  public:
+    /**
+     * Open (or create) a LevelDB database.
+     * @param &path The folder of the database.
+     * @param &options The tuning options.
+     * @param &error Set to the reason on failure.
+     * @return The engine, or `nullptr` on failure.
+     */
+    static std::shared_ptr<LevelDBBackend> open(
+      const boost::filesystem::path& path, const DatabaseOptions& options, std::string& error
+    );
+
+    bool get(const std::string& key, std::string& value, const Snapshot* snap) const override;
+    bool write(const std::vector<Write>& writes, bool sync, std::string& error) override;
+    std::unique_ptr<Iterator> iterator(const Snapshot* snap) const override;
+    std::shared_ptr<const Snapshot> snapshot() const override;
+};
+
+/**
+ * Engine that keeps everything in memory, in a sorted map.
+ * Meant for tests and ephemeral caches. Snapshots and iterators share the
+ * map until the next write, which then copies it (copy-on-write).
+ */
+class MemoryBackend : public DBBackend {
+  private:
+    using Map = std::map<std::string, std::string, std::less<>>;
+    std::shared_ptr<Map> data = std::make_shared<Map>(); ///< The data. Shared with snapshots and iterators.
+    mutable std::mutex dataLock;                         ///< Mutex for managing read/write access to the data.
+
+    class MemorySnapshot;
+    class MemoryIterator;
+
+    /// Get the current data, shared. Assumes dataLock is not locked.
+    std::shared_ptr<const Map> current() const;
+
+  public:
+    bool get(const std::string& key, std::string& value, const Snapshot* snap) const override;
+    bool write(const std::vector<Write>& writes, bool sync, std::string& error) override;
+    std::unique_ptr<Iterator> iterator(const Snapshot* snap) const override;
+    std::shared_ptr<const Snapshot> snapshot() const override;
+};
+
+/**
+ * Read-only engine over a sorted table file, mapped into memory.
+ * Opening only maps the file, so it's nearly free no matter its size,
+ * and lookups are binary searches straight over the mapped pages.
+ * Meant for big static datasets (e.g. ABI or token registries).
+ * Tables are written with TableBackend::Writer or Database::exportTable().
+ *
+ * File layout (integers are little-endian):
+ * - 8 bytes magic ("W3CTABL1")
+ * - Entries, sorted by key: `u32 keySize, u32 valueSize, key, value`
+ * - Index: `u64 offset` of each entry
+ * - Footer: `u64 indexOffset, u64 count`, then the magic again
+ */
+class TableBackend : public DBBackend {
+  private:
+    boost::interprocess::file_mapping file;     ///< The table file.
+    boost::interprocess::mapped_region region;  ///< The table file, mapped into memory.
+    const char* base = nullptr;                 ///< Start of the mapped file.
+    uint64_t size = 0;                          ///< Size of the mapped file.
+    uint64_t indexOffset = 0;                   ///< Offset of the index.
+    uint64_t count = 0;                         ///< Number of entries.
+
+    class TableIterator;
+
+    /**
+     * Get an entry.
+     * @param i The index of the entry.
+     * @param &key Set to the entry's key.
+     * @param &value Set to the entry's value.
+     * @return `true` on success, `false` if the entry is out of the file's bounds.
+     */
+    bool entry(uint64_t i, std::string_view& key, std::string_view& value) const;
+
+    /// Get the index of the first entry with a key greater than or equal to `key`.
+    uint64_t lowerBound(std::string_view key) const;
+
+  public:
+    static const std::string magic; ///< Magic bytes at the start and end of every table file.
+
+    /// Writer for table files. Keys have to be added in strictly increasing order.
+    class Writer {
+      private:
+        std::ofstream out;            ///< The file being written.
+        std::vector<uint64_t> index;  ///< Offset of each entry written so far.
+        std::string lastKey;          ///< Last key written, to enforce the order.
+        uint64_t offset = 0;          ///< Current write offset.
+
+      public:
+        /**
+         * Constructor. Creates (or truncates) the file.
+         * @param &path The path of the table file.
+         */
+        Writer(const boost::filesystem::path& path);
+
+        /**
+         * Add an entry.
+         * @param key The key. Has to be greater than the last one added.
+         * @param value The value.
+         * @return `true` on success, `false` if out of order or the file can't be written.
+         */
+        bool add(std::string_view key, std::string_view value);
+
+        /**
+         * Write the index and footer, and close the file.
+         * @return `true` on success, `false` otherwise.
+         */
+        bool finish();
+    };
+
+    /**
+     * Map a table file.
+     * @param &path The path of the table file.
+     * @param &error Set to the reason on failure.
+     * @return The engine, or `nullptr` if the file doesn't exist or isn't a valid table.
+     */
+    static std::shared_ptr<TableBackend> open(const boost::filesystem::path& path, std::string& error);
+
+    bool get(const std::string& key, std::string& value, const Snapshot* snap) const override;
+    bool write(const std::vector<Write>& writes, bool sync, std::string& error) override;
+    std::unique_ptr<Iterator> iterator(const Snapshot* snap) const override;
+    std::shared_ptr<const Snapshot> snapshot() const override;
+};
+
+#endif  // DBBACKEND_H
@@ -54,6 +54,14 @@ class Error {
      * \arg \c 33 - **JSON File Does Not Exist**
      * \arg \c 34 - **JSON File Read %Error**
      * \arg \c 35 - **JSON File Write %Error**
+     * \arg \c 36 - **RPC Batch Request Failed**
+     * \arg \c 37 - **Transaction Receipt Timeout**
+     * \arg \c 38 - **Transaction Reverted**
+     * \arg \c 39 - **ABI Invalid Encoded Data**
+     * \arg \c 40 - **ABI Unknown %Error Selector**
+     * \arg \c 41 - **ABI Unknown Event**
+     * \arg \c 42 - **ABI Invalid Int**
+     * \arg \c 43 - **RPC Request Failed**
      * \arg \c 999 - **Unknown %Error**
      */
     static const std::map<uint64_t, std::string> codeMap;
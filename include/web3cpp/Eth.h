@@ -1,7 +1,10 @@
 #ifndef ETH_H
 #define ETH_H
 
+#include <algorithm>
+#include <deque>
 #include <future>
+#include <map>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -11,6 +14,8 @@
 #include <web3cpp/Net.h>
 #include <web3cpp/Provider.h>
 #include <web3cpp/RPC.h>
+#include <web3cpp/Solidity.h>
+#include <web3cpp/Storage.h>
 #include <web3cpp/Utils.h>
 
 #include "version.h"
@@ -28,6 +33,41 @@ class Eth {
   private:
     const std::unique_ptr<Provider>& provider; ///< Pointer to Web3::defaultProvider.
 
+    /**
+     * Send a slice of a request list as a single JSON-RPC batch.
+     * Each request's id is overwritten with its index on the list, so
+     * responses can be matched back regardless of the order the node
+     * answers them.
+     * @param requests A JSON array of requests built with the RPC namespace.
+     * @param start The index of the first request of the slice.
+     * @param end The index after the last request of the slice.
+     * @return A list with one response per request of the slice, in order.
+     *         Requests the node didn't answer get an "error" object instead.
+     */
+    std::vector<json> _sendBatch(const json& requests, uint64_t start, uint64_t end);
+
+    /**
+     * Send a list of requests as JSON-RPC batches, synchronously.
+     * @param requests A JSON array of requests built with the RPC namespace.
+     * @param batchSize The maximum number of requests sent per HTTP request.
+     * @param maxConcurrency (optional) The maximum number of batches in flight
+     *                       at the same time. Defaults to 1 (one after another).
+     * @return A JSON array with one response per request, in the same order
+     *         as the requests.
+     */
+    json _batchRequest(
+      const json& requests, unsigned int batchSize, unsigned int maxConcurrency = 1
+    );
+
+    /**
+     * Resolve a block tag to a fixed block number, so multiple batches
+     * read from the exact same block. "latest" and "pending" are resolved
+     * with `eth_blockNumber`, anything else is returned as is.
+     * @param block The block tag or number to pin.
+     * @return The pinned block number in hex, or an empty string on failure.
+     */
+    std::string _pinBlock(const std::string& block);
+
   public:
     /**
      * Constructor.
@@ -111,6 +151,49 @@ class Eth {
       const std::string& address, const std::string& defaultBlock = ""
     );
 
+    /**
+     * Get the balances of many addresses at once.
+     * Requests are sent as JSON-RPC batches, all pinned to the same block,
+     * with at most `maxConcurrency` batches in flight at the same time.
+     * @param addresses The addresses to get the balances from.
+     * @param &err Error object.
+     * @param defaultBlock (optional) The block to use as reference. Defaults to Eth::defaultBlock.
+     *                     "latest" and "pending" are resolved to a block number before reading.
+     * @param batchSize (optional) How many addresses are read per request. Defaults to 100.
+     * @param maxConcurrency (optional) How many requests can be in flight at once. Defaults to 4.
+     * @param *failed (optional) Set to a vector aligned with the given addresses,
+     *                `true` for each balance that couldn't be read (missing or
+     *                malformed result). Has to outlive the future.
+     * @return The balances in Wei, aligned with the given addresses.
+     *         Balances that couldn't be read are set to 0.
+     */
+    std::future<std::vector<BigNumber>> getBalances(
+      const std::vector<std::string>& addresses, Error &err,
+      const std::string& defaultBlock = "", unsigned int batchSize = 100,
+      unsigned int maxConcurrency = 4, std::vector<bool>* failed = nullptr
+    );
+
+    /**
+     * Same as getBalances(), but reads the balances of an ERC20 token
+     * (`balanceOf(address)`) instead of the native currency.
+     * @param token The ERC20 token contract's address.
+     * @param addresses The addresses to get the balances from.
+     * @param &err Error object.
+     * @param defaultBlock (optional) The block to use as reference. Defaults to Eth::defaultBlock.
+     * @param batchSize (optional) How many addresses are read per request. Defaults to 100.
+     * @param maxConcurrency (optional) How many requests can be in flight at once. Defaults to 4.
+     * @param *failed (optional) Same as in getBalances(). An empty "0x" result
+     *                (e.g. the token address has no code) counts as a failure.
+     * @return The token balances in the token's smallest unit, aligned with
+     *         the given addresses. Balances that couldn't be read are set to 0.
+     */
+    std::future<std::vector<BigNumber>> getTokenBalances(
+      const std::string& token, const std::vector<std::string>& addresses,
+      Error &err, const std::string& defaultBlock = "",
+      unsigned int batchSize = 100, unsigned int maxConcurrency = 4,
+      std::vector<bool>* failed = nullptr
+    );
+
     /**
      * Get the value in storage at a specific position of an address.
      * @param address The address to get the storage from.
@@ -130,6 +213,30 @@ class Eth {
       const std::string& address, const BigNumber& position, const std::string& defaultBlock = ""
     );
 
+    /**
+     * Read many storage slots of an address at once.
+     * Reads are sent as JSON-RPC batches, all pinned to the same block, so
+     * the result is a consistent snapshot of the contract's state.
+     * Slots can be derived with the functions from the Storage namespace.
+     * @param address The address to get the storage from.
+     * @param slots The list of slots to read.
+     * @param &err Error object.
+     * @param defaultBlock (optional) The block to use as reference. Defaults to Eth::defaultBlock.
+     *                     "latest" and "pending" are resolved to a block number before reading.
+     * @param batchSize (optional) How many slots are read per request. Defaults to 100.
+     * @return A map with the value of each slot that was successfully read.
+     */
+    std::future<std::map<dev::h256, dev::h256>> getStorageSnapshot(
+      const std::string& address, const std::vector<dev::h256>& slots, Error &err,
+      const std::string& defaultBlock = "", unsigned int batchSize = 100
+    );
+
+    /// Overload of getStorageSnapshot() that reads `count` contiguous slots from `startSlot`.
+    std::future<std::map<dev::h256, dev::h256>> getStorageSnapshot(
+      const std::string& address, const dev::h256& startSlot, uint64_t count,
+      Error &err, const std::string& defaultBlock = "", unsigned int batchSize = 100
+    );
+
     /**
      * Get the code at a specific address.
      * @param address The address to get the code from.
@@ -290,6 +397,16 @@ class Eth {
       std::string nonce, std::string powHash, std::string digest
     );
 
+    /**
+     * Send multiple requests at once as JSON-RPC batches.
+     * @param requests A JSON array of requests built with the RPC namespace.
+     * @param batchSize (optional) The maximum number of requests sent per
+     *                  HTTP request. Defaults to 100.
+     * @return A JSON array with one response per request, in the same order
+     *         as the requests.
+     */
+    std::future<json> batchRequest(const json& requests, unsigned int batchSize = 100);
+
     /**
      * Get the chain ID of the current provider.
      * @return The chain ID integer.
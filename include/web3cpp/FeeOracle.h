@@ -0,0 +1,131 @@
+#ifndef FEEORACLE_H
+#define FEEORACLE_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/BlockWatcher.h>
+#include <web3cpp/Error.h>
+#include <web3cpp/Eth.h>
+#include <web3cpp/RPC.h>
+#include <web3cpp/Utils.h>
+
+using json = nlohmann::ordered_json;
+
+/**
+ * In-memory gas price and fee oracle, refreshed in the background.
+ * On each new head from a BlockWatcher, `eth_gasPrice`, `eth_feeHistory`
+ * and the head block are fetched in one JSON-RPC batch and turned into an
+ * immutable Snapshot. Readers only load a shared pointer to the latest
+ * snapshot, so suggestions don't touch the network on the hot path
+ * (e.g. right before Wallet::buildTransaction()).
+ */
+
+class FeeOracle {
+  public:
+    /// Fee data computed from a single head.
+    struct Snapshot {
+      uint64_t block = 0;                   ///< Head the data was computed from.
+      BigNumber gasPrice = 0;               ///< Node's `eth_gasPrice` suggestion, in Wei.
+      BigNumber baseFee = 0;                ///< Base fee of the head block, in Wei (0 before London).
+      BigNumber nextBaseFee = 0;            ///< Base fee of the next block, in Wei (0 before London).
+      std::vector<double> percentiles;      ///< Sampled priority fee percentiles.
+      std::vector<BigNumber> priorityFees;  ///< Median priority fee over the window, per percentile, in Wei.
+    };
+
+  private:
+    BlockWatcher& watcher;                  ///< Watcher that drives the refreshes.
+    Eth eth;                                ///< Eth object used for batched requests.
+    std::vector<double> percentiles;        ///< Priority fee percentiles to sample.
+    unsigned int historyBlocks;             ///< Number of blocks in the fee history window.
+    uint64_t subId = 0;                     ///< Subscription id on the watcher.
+    std::shared_ptr<const Snapshot> snap;   ///< Latest snapshot. Only accessed through std::atomic_load/store.
+
+    /**
+     * Get the priority fee for the configured percentile closest to the given one.
+     * @param &s The snapshot to read from.
+     * @param percentile The desired percentile.
+     * @return The priority fee in Wei, or 0 if the snapshot has no fee history.
+     */
+    static BigNumber priorityFeeFor(const Snapshot& s, double percentile);
+
+  public:
+    /**
+     * Constructor. Subscribes to the watcher; the first snapshot is available
+     * after the first head (or after calling refresh()).
+     * @param &_watcher The watcher that will drive the refreshes.
+     * @param _percentiles (optional) Priority fee percentiles to sample, from 0 to 100.
+     *                     Sorted and deduplicated. Defaults to 10, 50 and 90.
+     * @param _historyBlocks (optional) Number of blocks in the fee history window.
+     *                       Defaults to 20.
+     * @throw std::invalid_argument if there are no percentiles, or any of them is out of range.
+     */
+    FeeOracle(
+      BlockWatcher& _watcher, std::vector<double> _percentiles = {10, 50, 90},
+      unsigned int _historyBlocks = 20
+    );
+
+    /// Destructor. Unsubscribes from the watcher.
+    ~FeeOracle();
+
+    /**
+     * Fetch fresh fee data and replace the current snapshot, synchronously.
+     * Called automatically on each new head.
+     * @param head The head to compute the data from.
+     * @return `true` on success, `false` on failure (the previous snapshot is kept).
+     */
+    bool refresh(uint64_t head);
+
+    /**
+     * Replace the current snapshot with fee data that was already fetched
+     * (the responses to `eth_gasPrice`, `eth_feeHistory` and `eth_getBlockByNumber`).
+     * Fee history and base fee may be missing (e.g. pre-London chains),
+     * but any field that is there has to be valid.
+     * @param head The head the data was fetched for.
+     * @param &price The `eth_gasPrice` response.
+     * @param &history The `eth_feeHistory` response, sampling the oracle's percentiles.
+     * @param &block The `eth_getBlockByNumber` response for the head.
+     * @return `true` on success, `false` on failure (the previous snapshot is kept).
+     */
+    bool update(uint64_t head, const json& price, const json& history, const json& block);
+
+    /// Get the latest snapshot, or a null pointer if none was taken yet.
+    std::shared_ptr<const Snapshot> snapshot() const { return std::atomic_load(&this->snap); }
+
+    /// Check if there's a snapshot available.
+    bool ready() const { return this->snapshot() != nullptr; }
+
+    /**
+     * Suggest a priority fee (tip) for EIP-1559 transactions.
+     * @param percentile (optional) The desired percentile. Defaults to 50.
+     * @return The priority fee in Wei, or 0 if there's no data.
+     */
+    BigNumber maxPriorityFee(double percentile = 50) const;
+
+    /**
+     * Suggest a max fee for EIP-1559 transactions: twice the next base fee
+     * plus the priority fee. As the base fee rises at most 12.5% per full
+     * block, that covers about six full blocks in a row.
+     * @param percentile (optional) The priority fee percentile. Defaults to 50.
+     * @return The max fee in Wei, or 0 if there's no data.
+     */
+    BigNumber maxFee(double percentile = 50) const;
+
+    /**
+     * Suggest a gas price for legacy transactions (e.g. Wallet::buildTransaction()).
+     * This is the highest between the node's suggestion and the next base fee
+     * plus the priority fee for the given percentile.
+     * @param percentile (optional) The priority fee percentile. Defaults to 50.
+     * @return The gas price in Wei, or 0 if there's no data.
+     */
+    BigNumber gasPrice(double percentile = 50) const;
+};
+
+#endif  // FEEORACLE_H
@@ -0,0 +1,101 @@
+#ifndef HISTORYWRITER_H
+#define HISTORYWRITER_H
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/BoundedQueue.h>
+#include <web3cpp/DB.h>
+#include <web3cpp/TxIndex.h>
+#include <web3cpp/TxRecord.h>
+
+using json = nlohmann::ordered_json;
+
+/**
+ * Write-behind queue for transaction histories.
+ * Saving a transaction only queues its raw signature. A background worker
+ * then decodes the queued transactions (RLP decode, sender recovery,
+ * formatting) and writes them in batches, so the caller never waits
+ * for the decoding or the disk. Use flush() when the transactions
+ * have to be readable and durable.
+ */
+
+class HistoryWriter {
+  private:
+    /// A queued transaction, or a flush barrier.
+    struct Item {
+      TxIndex history;          ///< History of the account.
+      std::string signedTx;     ///< Raw transaction signature.
+      uint64_t unixDate = 0;    ///< When the transaction was queued, in seconds since the epoch.
+      uint64_t barrier = 0;     ///< Ticket of the flush that queued this barrier. 0 for transactions.
+    };
+
+    Database db;                      ///< Database the histories belong to. Writes are batched on it.
+    uint64_t maxBatch;                ///< Maximum number of transactions per batch.
+    BoundedQueue<Item> queue;         ///< Transactions waiting to be written.
+    uint64_t nextBarrier = 0;         ///< Ticket of the last flush requested.
+    uint64_t doneBarrier = 0;         ///< Ticket of the last flush completed.
+    bool failed = false;              ///< Indicates a write failed since the last flush.
+    std::mutex flushLock;             ///< Mutex for managing read/write access to the flush state.
+    std::condition_variable flushed;  ///< Signaled when a flush completes.
+    std::thread worker;               ///< Thread that writes the queued transactions.
+
+    /// Worker loop. Runs until the queue is closed and drained.
+    void run();
+
+    /**
+     * Decode a transaction and add it to a batch.
+     * @param &batch The batch.
+     * @param &item The queued transaction.
+     * @return `true` on success, `false` if the transaction couldn't be decoded or written.
+     */
+    bool add(Database::Batch& batch, const Item& item);
+
+  public:
+    /**
+     * Constructor. Starts the worker.
+     * @param &_db The database the histories belong to (e.g. the wallet's).
+     *             Histories from other databases work, but aren't batched.
+     * @param _maxBatch Maximum number of transactions written per batch.
+     * @param capacity Maximum number of queued transactions. Saving blocks
+     *                 while the queue is full.
+     */
+    HistoryWriter(const Database& _db, uint64_t _maxBatch = 1024, uint64_t capacity = 65536);
+
+    /// Destructor. Writes everything still queued, then stops the worker.
+    ~HistoryWriter();
+
+    HistoryWriter(const HistoryWriter&) = delete;             ///< Not copyable.
+    HistoryWriter& operator=(const HistoryWriter&) = delete;  ///< Not copyable.
+
+    /**
+     * Queue a transaction to be saved.
+     * @param &history The history of the account. The transaction is
+     *                 written along with its index entries.
+     * @param signedTx The raw transaction signature that will be decoded and stored.
+     *                 It's dated now, not when the worker gets to it.
+     * @return `true` if queued, `false` if the writer is stopping.
+     */
+    bool enqueue(const TxIndex& history, std::string signedTx);
+
+    /**
+     * Wait until every transaction queued before this call is written
+     * and synced to disk.
+     * @return `true` on success, `false` if any transaction failed to be
+     *         decoded or written since the last flush.
+     */
+    bool flush();
+
+    /// Get the number of transactions (and flushes) still queued.
+    uint64_t pending() const { return this->queue.size(); }
+};
+
+#endif  // HISTORYWRITER_H
@@ -0,0 +1,175 @@
+#ifndef NONCEMANAGER_H
+#define NONCEMANAGER_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/DB.h>
+#include <web3cpp/Error.h>
+#include <web3cpp/Net.h>
+#include <web3cpp/Provider.h>
+#include <web3cpp/RPC.h>
+#include <web3cpp/Utils.h>
+
+using json = nlohmann::ordered_json;
+
+/**
+ * Thread-safe local nonce tracker for a single account.
+ * Nonces are handed out locally without a network round trip, and every
+ * nonce handed out stays "pending" until it's either confirmed or failed.
+ * A failed nonce is only given back on its own: it's reused right away if
+ * it was the highest one handed out, or kept as a gap to be filled by the
+ * next transaction otherwise. Nonces still outstanding are never handed out
+ * twice, and syncing with the network only ever moves the state forward.
+ * The state is synced from the network's `pending` tag on first use, and
+ * persisted to the account's transaction database so it survives restarts
+ * (each pending nonce in its own key, so each change is a small write).
+ */
+
+class NonceManager {
+  private:
+    std::string address;                        ///< Address of the account the nonces belong to.
+    const std::unique_ptr<Provider>& provider;  ///< Pointer to Web3::defaultProvider.
+    Database db;                                ///< The account's transaction database (shares the account's handle).
+    bool synced = false;                        ///< Indicates the state was synced at least once.
+    bool stored = false;                        ///< Indicates a persisted state was loaded on construction.
+    uint64_t nextNonce = 0;                     ///< Next new nonce to be handed out (gaps are handed out first).
+    std::map<uint64_t, std::string> pendingTxs; ///< Handed out nonces not yet confirmed, and their tx hashes (if sent).
+    std::set<uint64_t> gaps;                    ///< Failed nonces below nextNonce, to be handed out again.
+    mutable std::mutex nonceLock;               ///< Mutex for managing read/write access to the nonce state.
+
+    /**
+     * Fetch the `pending` transaction count from the network.
+     * Doesn't need nonceLock, so other calls aren't blocked by the request.
+     * @param &out Set to the transaction count.
+     * @param &err Error object.
+     * @return `true` on success, `false` on failure.
+     */
+    bool _fetch(uint64_t& out, Error &err) const;
+
+    /**
+     * Sync the state with a `pending` transaction count from the network.
+     * The first sync takes the network count as it is, since nothing can be
+     * in flight yet. After that, the state only moves forward, as nonces
+     * handed out in the meantime may not have reached the node yet.
+     * Assumes nonceLock is already locked.
+     * @param networkNonce The account's `pending` transaction count.
+     */
+    void _apply(uint64_t networkNonce);
+
+    /// Load the persisted state, if it exists. Only called on construction.
+    bool _load();
+
+    /// Add the write for the nonce counters (next and gaps) to a batch. Assumes nonceLock is already locked.
+    void _saveState(Database::Batch& batch) const;
+
+    /**
+     * Give back a nonce that was already removed from the pending list:
+     * the counter goes back if it was the highest one, otherwise it's kept as a gap.
+     * Assumes nonceLock is already locked.
+     * @param nonce The nonce to give back.
+     * @param &batch The batch to add the deleted pending key to.
+     */
+    void _release(uint64_t nonce, Database::Batch& batch);
+
+    /// Get the database key for a pending nonce.
+    static std::string _pendingKey(uint64_t nonce);
+
+  public:
+    /// Key used to persist the state in the account's transaction database.
+    static const std::string dbKey;
+
+    /**
+     * Constructor. Loads the persisted state, if any, without touching the network.
+     * @param _address The address of the account.
+     * @param *_provider Pointer to the provider used by the account.
+     * @param &_db The account's transaction database.
+     */
+    NonceManager(
+      const std::string& _address, const std::unique_ptr<Provider>& _provider, const Database& _db
+    ) : address(_address), provider(_provider), db(_db) { this->stored = this->_load(); }
+
+    /**
+     * Hand out the next nonce and mark it as pending.
+     * Syncs with the network first if the state was never synced.
+     * @param &err Error object.
+     * @return The nonce to use for the next transaction.
+     */
+    uint64_t next(Error &err);
+
+    /**
+     * Get the next nonce that would be handed out, without reserving it.
+     * This is the locally tracked value and never makes a network request,
+     * so it's only as fresh as the last sync (see isSynced(), resync()
+     * and Wallet::refreshNonces()).
+     * @return The next nonce, or the persisted one (or 0) if never synced.
+     */
+    uint64_t peek() const;
+
+    /// Check if the state was synced with the network at least once.
+    bool isSynced() const;
+
+    /**
+     * Link a sent transaction to its pending nonce.
+     * @param nonce The nonce used by the transaction.
+     * @param txHash The hash of the sent transaction.
+     */
+    void markSent(uint64_t nonce, const std::string& txHash);
+
+    /**
+     * Mark a nonce as confirmed (mined), removing it and every nonce
+     * below it from the pending list.
+     * @param nonce The nonce used by the mined transaction.
+     */
+    void markConfirmed(uint64_t nonce);
+
+    /**
+     * Mark a nonce as failed (e.g. the send was rejected by the node),
+     * giving it back. Only that nonce is released: it's reused by the next
+     * transaction, either because it was the highest one outstanding or as
+     * a gap to be filled. Nonces handed out after it are left as they are.
+     * @param nonce The nonce used by the failed transaction.
+     */
+    void markFailed(uint64_t nonce);
+
+    /**
+     * Make sure a nonce isn't used over a gap. If a lower nonce was released
+     * and not handed out again, the given nonce is released instead and the
+     * lowest gap is returned in its place, so a transaction that wasn't sent
+     * yet doesn't get stuck behind one that never will be.
+     * @param nonce The nonce handed out to a transaction that wasn't sent yet.
+     * @return The nonce the transaction should use (the same one if there's no gap below it).
+     */
+    uint64_t fillGap(uint64_t nonce);
+
+    /**
+     * Fetch the network's `pending` tag and sync the state with it (see sync()).
+     * @param &err Error object.
+     * @return `true` on success, `false` on failure.
+     */
+    bool resync(Error &err);
+
+    /**
+     * Sync the state with a `pending` transaction count that was already
+     * fetched elsewhere (e.g. by Wallet::refreshNonces() for many accounts
+     * at once), without a network request of its own. Once synced,
+     * the state only moves forward, so nonces already handed out are kept.
+     * @param networkNonce The account's `pending` transaction count.
+     */
+    void sync(uint64_t networkNonce);
+
+    /**
+     * Get the nonces that were handed out but not confirmed yet.
+     * @return A map with each pending nonce and its transaction hash
+     *         (or an empty string if not sent yet).
+     */
+    std::map<uint64_t, std::string> pending() const;
+};
+
+#endif  // NONCEMANAGER_H
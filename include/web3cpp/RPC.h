@@ -5,6 +5,7 @@
 #include <cctype>
 #include <string>
 #include <sstream>
+#include <vector>
 
 #include <web3cpp/Error.h>
 #include <web3cpp/Utils.h>
@@ -215,6 +216,19 @@ namespace RPC {
    */
   json eth_estimateGas(const json& callObject, Error &err);
 
+  /**
+   * Build data for `eth_feeHistory`.
+   * @param blockCount Number of blocks in the requested range.
+   * @param newestBlock Highest block of the requested range.
+   * @param rewardPercentiles Ascending list of percentiles (0-100) of priority
+   *                          fees to be sampled from each block.
+   * @param &err Error object.
+   */
+  json eth_feeHistory(
+    uint64_t blockCount, const std::string& newestBlock,
+    const std::vector<double>& rewardPercentiles, Error &err
+  );
+
   /**
    * Build data for `eth_getBlockByHash`.
    * @param hash The hash of a block.
@@ -7,6 +7,7 @@
 #include <vector>
 
 #include <nlohmann/json.hpp>
+#include <web3cpp/ABI.h>
 #include <web3cpp/Error.h>
 #include <web3cpp/Utils.h>
 
@@ -36,6 +37,8 @@ namespace Solidity {
    * - bool and bool[]
    * - bytes and bytes[]
    * - string and string[]
+   * - any other ABI type (intN/uintN, bytesN, T[k], nested arrays, canonical
+   *   tuples such as "(uint256,bytes32)"), through ABI::Type
    * @param type The type to check.
    * @param value The value to check.
    * @param &err Error object.
@@ -43,6 +46,26 @@ namespace Solidity {
    */
   bool checkType(const std::string& type, const json& value, Error &err);
 
+  /**
+   * Check if a given value is valid for a given ABI type, recursively.
+   * Numbers have to fit in the type's size, bytesN values in N bytes,
+   * and arrays and tuples have to be JSON arrays of the right length.
+   * @param &type The type to check.
+   * @param &value The value to check (see ABI::Encoder::add()).
+   * @param &err Error object.
+   * @return `true` if value and type match, `false` otherwise.
+   */
+  bool checkType(const ABI::Type& type, const json& value, Error &err);
+
+  /**
+   * Same as checkType(), but returns the error code instead of setting an
+   * Error object, for checking many values without creating one for each.
+   * @param &type The type to check.
+   * @param &value The value to check.
+   * @return The error code, or 0 if value and type match.
+   */
+  uint64_t checkTypeCode(const ABI::Type& type, const json& value);
+
   /**
    * Pack an individual function into %Solidity format.
    * @param func The full packed function signature (e.g. `foo(bar,baz[])`, not just `foo`).
@@ -127,6 +150,7 @@ namespace Solidity {
    * Each arg has to be a JSON object with "type" and "value" (or "t" and "v")
    * and will be encoded in order.
    * ALL VALUES MUST BE STRINGS, INCLUDING NUMBERS.
+   * Arrays and tuples (e.g. "(uint256,string)[2]") are JSON arrays of those.
    * Example:
    *
    *     json j = {
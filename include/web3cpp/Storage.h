@@ -0,0 +1,56 @@
+#ifndef STORAGE_H
+#define STORAGE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <web3cpp/devcore/Address.h>
+#include <web3cpp/devcore/FixedHash.h>
+#include <web3cpp/devcore/SHA3.h>
+#include <web3cpp/Utils.h>
+
+/**
+ * Namespace for deriving contract storage slot positions the same way
+ * [Solidity lays them out](https://docs.soliditylang.org/en/latest/internals/layout_in_storage.html).
+ * A summed up rationale of how each layout is derived:
+ * - value types: the declared slot itself
+ * - mapping(K => V): keccak256(pad32(key) . pad32(slot))
+ * - dynamic array T[]: keccak256(pad32(slot)) + (index * slotsPerElement)
+ * Derived slots can be fed directly to Eth::getStorageSnapshot().
+ */
+
+namespace Storage {
+  /**
+   * Derive the slot of a mapping entry.
+   * @param key The mapping key, already left-padded to 32 bytes (e.g. a uint256 or bytes32 key).
+   * @param slot The slot where the mapping itself is declared.
+   * @return The slot where the value for the given key is stored.
+   */
+  dev::h256 mappingSlot(const dev::h256& key, const dev::h256& slot);
+
+  /// Overload of mappingSlot() that takes an address as the key.
+  dev::h256 mappingSlot(const dev::Address& key, const dev::h256& slot);
+
+  /**
+   * Derive the slot of a dynamic array element.
+   * @param slot The slot where the array itself (its length) is declared.
+   * @param index The index of the element.
+   * @param slotsPerElement (optional) How many slots each element takes.
+   *                        Defaults to 1 (any type that fits into 32 bytes).
+   * @return The slot where the element at the given index starts.
+   */
+  dev::h256 arraySlot(
+    const dev::h256& slot, const BigNumber& index, unsigned int slotsPerElement = 1
+  );
+
+  /**
+   * Build a contiguous range of slots (e.g. for struct members or fixed arrays).
+   * @param start The first slot of the range.
+   * @param count The number of slots in the range.
+   * @return A list with `count` slots, starting at `start`.
+   */
+  std::vector<dev::h256> slotRange(const dev::h256& start, uint64_t count);
+};
+
+#endif  // STORAGE_H
@@ -0,0 +1,71 @@
+#ifndef TIMERSERVICE_H
+#define TIMERSERVICE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+/**
+ * Shared timer executor for the library.
+ * All timers run on a single background thread with an asio io_context,
+ * so any number of objects (e.g. every Wallet's password expiry) can
+ * schedule delayed work without each one spawning a sleeper thread.
+ * Cancelling is synchronous: once cancel() returns, the task either ran
+ * completely or never will.
+ */
+
+class TimerService {
+  public:
+    using TimerId = uint64_t; ///< Identifier for a scheduled task. 0 is never used.
+
+  private:
+    boost::asio::io_context ioc;  ///< Context that runs the timers.
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work; ///< Keeps ioc running while idle.
+    std::map<TimerId, std::shared_ptr<boost::asio::steady_timer>> timers; ///< Pending timers, per id.
+    TimerId nextId = 1;           ///< Next id to be handed out.
+    TimerId runningId = 0;        ///< Id of the task running at the moment, if any.
+    std::mutex timerLock;         ///< Mutex for managing read/write access to the timers.
+    std::condition_variable doneCv; ///< Signaled when a task finishes running.
+    std::thread runner;           ///< Thread that runs ioc.
+
+    /// Private constructor, use instance() instead.
+    TimerService();
+
+  public:
+    /// Get the library-wide timer service. Started on first use.
+    static TimerService& instance();
+
+    /// Destructor. Pending tasks are dropped without running.
+    ~TimerService();
+
+    TimerService(const TimerService&) = delete;             ///< Not copyable.
+    TimerService& operator=(const TimerService&) = delete;  ///< Not copyable.
+
+    /**
+     * Schedule a task to run once after a delay.
+     * @param delay How long to wait before running the task.
+     * @param task The task to run. Runs on the timer thread, so it should be quick.
+     * @return An id that can be used to cancel the task.
+     */
+    TimerId schedule(std::chrono::milliseconds delay, std::function<void()> task);
+
+    /**
+     * Cancel a scheduled task. If the task is running at the moment, waits
+     * for it to finish (unless called from the task itself).
+     * @param id The id returned by schedule(). 0 is ignored.
+     * @return `true` if the task was cancelled before running, `false` otherwise.
+     */
+    bool cancel(TimerId id);
+};
+
+#endif  // TIMERSERVICE_H
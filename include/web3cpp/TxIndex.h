@@ -0,0 +1,162 @@
+#ifndef TXINDEX_H
+#define TXINDEX_H
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <web3cpp/devcore/Address.h>
+#include <web3cpp/DB.h>
+#include <web3cpp/TxRecord.h>
+
+/**
+ * Transaction history of an account, with secondary indexes.
+ * Records are stored by hash (see TxRecord::key()), and every record also
+ * gets index entries (empty values) under the internal "_idx/" prefix:
+ * - `_idx/block/<block>/<hash>` (only for mined transactions)
+ * - `_idx/time/<unixDate>/<hash>`
+ * - `_idx/peer/<address>/<unixDate>/<hash>` for the sender and receiver
+ *   (or created contract), except the account itself
+ * - `_idx/status/<p|c|i>/<unixDate>/<hash>` (pending, confirmed, invalid)
+ *
+ * Numbers are fixed-width hex, so keys sort in numeric order and every
+ * query is a single range scan over its index. A record and its index
+ * entries are always written in the same batch. Queries also check each
+ * record against the entry that led to it, so an entry left stale by an
+ * interrupted write is never returned.
+ */
+
+class TxIndex {
+  private:
+    Database history;     ///< The account's history partition.
+    dev::Address owner;   ///< The account's address.
+
+    /**
+     * Get the index keys for a record.
+     * @param &record The record.
+     * @param &hash The record's key.
+     * @return The index keys.
+     */
+    std::vector<std::string> indexKeys(const TxRecord& record, const std::string& hash) const;
+
+    /**
+     * Load the records an index range points to.
+     * @param &prefix The index prefix (e.g. "_idx/time/").
+     * @param from The lowest number in the range, right after the prefix.
+     * @param to The highest number in the range (inclusive).
+     * @param limit Maximum number of records. 0 means no limit.
+     * @param reverse Scan from the highest number to the lowest.
+     * @return The records, in index order.
+     */
+    std::vector<TxRecord> scan(
+      const std::string& prefix, uint64_t from, uint64_t to, uint64_t limit, bool reverse
+    ) const;
+
+  public:
+    /// Confirmation status of a transaction, as indexed.
+    enum class Status { Pending, Confirmed, Invalid };
+
+    static const std::string prefix;  ///< Prefix for every index key.
+    static constexpr uint64_t maxValue = std::numeric_limits<uint64_t>::max(); ///< Open upper bound for queries.
+
+    /// Empty constructor.
+    TxIndex(){}
+
+    /**
+     * Default constructor.
+     * @param &_history The account's history partition.
+     * @param &_owner The account's address, left out of the counterparty index.
+     */
+    TxIndex(const Database& _history, const dev::Address& _owner)
+      : history(_history), owner(_owner) {}
+
+    /// Getter for the history partition.
+    const Database& db() const { return this->history; }
+
+    /// Get the status of a record.
+    static Status status(const TxRecord& record) {
+      return (record.invalid) ? Status::Invalid :
+        (record.confirmed) ? Status::Confirmed : Status::Pending;
+    }
+
+    /**
+     * Queue a record and its index entries on a batch. If the record is
+     * already stored, its old index entries are deleted in the same batch.
+     * @param &batch The batch. Has to belong to the same database as the history.
+     * @param &record The record.
+     * @return `true` if queued, `false` if the batch belongs to another database.
+     */
+    bool add(Database::Batch& batch, const TxRecord& record) const;
+
+    /**
+     * Save a record and its index entries atomically.
+     * @param &record The record.
+     * @return `true` on success, `false` on failure.
+     */
+    bool save(const TxRecord& record);
+
+    /**
+     * Get a record.
+     * @param &hash The record's key.
+     * @param &record Set to the record.
+     * @return `true` if found, `false` otherwise.
+     */
+    bool get(const std::string& hash, TxRecord& record) const;
+
+    /**
+     * Get the transactions mined in a range of blocks.
+     * @param first The first block (inclusive).
+     * @param last The last block (inclusive).
+     * @param limit Maximum number of records. 0 means no limit.
+     * @param reverse Newest first.
+     * @return The records, ordered by block.
+     */
+    std::vector<TxRecord> byBlock(
+      uint64_t first, uint64_t last = maxValue, uint64_t limit = 0, bool reverse = false
+    ) const;
+
+    /**
+     * Get the transactions saved in a period.
+     * @param since The start of the period, in seconds since the epoch (inclusive).
+     * @param until The end of the period, in seconds since the epoch (inclusive).
+     * @param limit Maximum number of records. 0 means no limit.
+     * @param reverse Newest first.
+     * @return The records, ordered by date.
+     */
+    std::vector<TxRecord> byTime(
+      uint64_t since, uint64_t until = maxValue, uint64_t limit = 0, bool reverse = false
+    ) const;
+
+    /**
+     * Get the transactions exchanged with an address in a period
+     * (e.g. every transfer to a given address in the last day).
+     * @param &party The other address (sender, receiver or created contract).
+     * @param since The start of the period, in seconds since the epoch (inclusive).
+     * @param until The end of the period, in seconds since the epoch (inclusive).
+     * @param limit Maximum number of records. 0 means no limit.
+     * @param reverse Newest first.
+     * @return The records, ordered by date.
+     */
+    std::vector<TxRecord> byCounterparty(
+      const dev::Address& party, uint64_t since = 0, uint64_t until = maxValue,
+      uint64_t limit = 0, bool reverse = false
+    ) const;
+
+    /**
+     * Get the transactions with a given status saved in a period.
+     * @param status The status.
+     * @param since The start of the period, in seconds since the epoch (inclusive).
+     * @param until The end of the period, in seconds since the epoch (inclusive).
+     * @param limit Maximum number of records. 0 means no limit.
+     * @param reverse Newest first.
+     * @return The records, ordered by date.
+     */
+    std::vector<TxRecord> byStatus(
+      Status status, uint64_t since = 0, uint64_t until = maxValue,
+      uint64_t limit = 0, bool reverse = false
+    ) const;
+};
+
+#endif  // TXINDEX_H
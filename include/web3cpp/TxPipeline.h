@@ -0,0 +1,199 @@
+#ifndef TXPIPELINE_H
+#define TXPIPELINE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/devcore/Common.h>
+#include <web3cpp/ethcore/TransactionBase.h>
+#include <web3cpp/BoundedQueue.h>
+#include <web3cpp/Error.h>
+#include <web3cpp/Eth.h>
+#include <web3cpp/RPC.h>
+#include <web3cpp/Utils.h>
+#include <web3cpp/Wallet.h>
+
+using json = nlohmann::ordered_json;
+
+/**
+ * Concurrent transaction submission pipeline for bulk sends (e.g. payouts).
+ * Transactions go through four stages, each running on its own thread(s)
+ * and connected by bounded queues, so a slow stage applies backpressure
+ * to the previous ones instead of buffering everything in memory:
+ * - build: assigns nonces in submission order from each account's NonceManager
+ * - sign: signs with keys decrypted only once per account (multiple workers)
+ * - send: broadcasts signed transactions in `eth_sendRawTransaction` batches
+ * - confirm: polls receipts in batches until mined or timed out
+ * Every submitted transaction gets exactly one TxPipeline::Result.
+ * When a transaction fails before it's sent, its nonce is given back, and
+ * transactions of the same account that weren't sent yet are moved down
+ * to it (and signed again), so none of them go out over the gap.
+ * Transactions already sent in the same batch as the failed one can't be
+ * moved, and wait for the gap to be filled by the next transaction.
+ */
+
+class TxPipeline {
+  public:
+    /// A transaction to be submitted, same fields as Wallet::buildTransaction().
+    struct Request {
+      std::string from;         ///< Sender address. Must be an account from the wallet.
+      std::string to;           ///< Receiver address (or contract address).
+      BigNumber value = 0;      ///< Value in Wei.
+      BigNumber gasLimit = 0;   ///< Gas limit.
+      BigNumber gasPrice = 0;   ///< Gas price in Wei.
+      std::string dataHex;      ///< Arbitrary data (e.g. packed ABI call).
+      bool creation = false;    ///< Indicates the transaction creates a contract.
+    };
+
+    /// Final outcome of a submitted transaction.
+    struct Result {
+      uint64_t id = 0;          ///< Ticket returned by submit().
+      std::string from;         ///< Sender address.
+      uint64_t nonce = 0;       ///< Nonce assigned to the transaction.
+      std::string hash;         ///< Transaction hash (empty if never sent).
+      json receipt;             ///< Transaction receipt (null if not confirmed).
+      uint64_t errorCode = 0;   ///< 0 on success, or the code of the stage that failed.
+    };
+
+    /// Tuning options for the pipeline.
+    struct Options {
+      unsigned int queueSize = 1024;          ///< Capacity of each stage queue.
+      unsigned int signers = 0;               ///< Number of sign workers. 0 means one per CPU core.
+      unsigned int sendBatchSize = 100;       ///< Max transactions per `eth_sendRawTransaction` batch.
+      unsigned int receiptBatchSize = 100;    ///< Max receipts per `eth_getTransactionReceipt` batch.
+      unsigned int pollIntervalMs = 1000;     ///< Interval between receipt polls.
+      unsigned int receiptTimeoutSec = 300;   ///< Time to wait for a receipt before giving up.
+      bool waitForReceipts = true;            ///< If false, transactions are done once sent.
+      std::function<void(const Result&)> onResult = nullptr; ///< Called (from a worker thread) for each finished transaction.
+    };
+
+  private:
+    /// Work item passed between stages.
+    struct Job {
+      uint64_t id = 0;                              ///< Ticket returned by submit().
+      Request req;                                  ///< Original request.
+      uint64_t nonce = 0;                           ///< Nonce assigned on the build stage.
+      dev::eth::TransactionSkeleton skel;           ///< Built transaction.
+      std::string signedTx;                         ///< Raw signed transaction.
+      std::string hash;                             ///< Transaction hash.
+      std::chrono::steady_clock::time_point sentAt; ///< When the transaction was sent.
+    };
+
+    /// Cached key of an account, decrypted by the first signer that needs it.
+    struct SecretEntry {
+      std::mutex lock;          ///< Mutex held while decrypting, so each key is only decrypted once.
+      bool loaded = false;      ///< Indicates the key was already decrypted (or failed to).
+      dev::Secret secret;       ///< The decrypted key.
+      uint64_t errorCode = 0;   ///< Error code of the decryption, if it failed.
+    };
+
+    Wallet& wallet;                   ///< Wallet that owns the sending accounts.
+    std::string password;             ///< Wallet's password, used to decrypt each account's key once.
+    Options opts;                     ///< Tuning options.
+    Eth eth;                          ///< Eth object used for batched requests.
+    BoundedQueue<Job> buildQueue;     ///< Queue for the build stage.
+    BoundedQueue<Job> signQueue;      ///< Queue for the sign stage.
+    BoundedQueue<Job> sendQueue;      ///< Queue for the send stage.
+    BoundedQueue<Job> confirmQueue;   ///< Queue for the confirm stage.
+    std::vector<std::thread> workers; ///< Threads running the stages.
+    uint64_t nextId = 0;              ///< Next ticket to be handed out by submit().
+    std::mutex submitLock;            ///< Mutex that keeps tickets in the same order as the build queue.
+    std::atomic<unsigned int> activeSigners{0};     ///< Sign workers still running.
+    std::map<std::string, std::shared_ptr<SecretEntry>> secrets; ///< Decrypted keys, per address.
+    std::mutex secretLock;            ///< Mutex for managing read/write access to the key cache (not the keys themselves).
+    std::map<uint64_t, Result> results; ///< Finished transactions, per ticket.
+    std::mutex resultLock;            ///< Mutex for managing read/write access to the results.
+    std::mutex joinLock;              ///< Mutex for joining the worker threads only once.
+    bool joined = false;              ///< Indicates the worker threads were already joined.
+
+    void buildLoop();     ///< Build stage.
+    void signLoop();      ///< Sign stage.
+    void sendLoop();      ///< Send stage.
+    void confirmLoop();   ///< Confirm stage.
+
+    /**
+     * Record the final outcome of a job and notify the callback.
+     * @param &job The finished job.
+     * @param errorCode 0 on success, or the error code of the failure.
+     * @param receipt (optional) The transaction receipt, if any.
+     */
+    void finish(const Job& job, uint64_t errorCode, json receipt = json());
+
+    /**
+     * Sign a job's transaction with its current nonce.
+     * @param &job The job to sign. Its signed transaction and hash are set on success.
+     * @param &err Error object.
+     */
+    void signJob(Job& job, Error &err);
+
+    /**
+     * Move a job that wasn't sent yet down to a lower nonce of its account
+     * that was given back after a failure (see NonceManager::fillGap()).
+     * @param &job The job to check.
+     * @return `true` if the job's nonce changed (and needs to be signed again), `false` otherwise.
+     */
+    bool fillGap(Job& job);
+
+    /**
+     * Get the decrypted key for an account, decrypting it on first use.
+     * The key cache is only locked to find or add the account's entry,
+     * so decrypting one account's key doesn't hold up signers of the others.
+     * @param &address The address of the account.
+     * @param &err Error object.
+     * @return The account's private key.
+     */
+    dev::Secret secretFor(const std::string& address, Error &err);
+
+    /**
+     * Give a nonce back to its account's NonceManager after a failure,
+     * so it can be handed out again.
+     * @param &job The failed job.
+     */
+    void releaseNonce(const Job& job);
+
+  public:
+    /**
+     * Constructor. Starts the worker threads right away.
+     * @param &_wallet The wallet that owns the sending accounts.
+     * @param &_password The wallet's password.
+     * @param _opts Tuning options.
+     */
+    TxPipeline(Wallet& _wallet, const std::string& _password, Options _opts);
+
+    /// Constructor with the default tuning options.
+    TxPipeline(Wallet& _wallet, const std::string& _password);
+
+    /// Destructor. Closes the pipeline and waits for in-flight transactions.
+    ~TxPipeline();
+
+    /**
+     * Submit a transaction to the pipeline.
+     * Blocks while the build queue is full.
+     * @param req The transaction to submit.
+     * @return A ticket identifying the transaction in the results,
+     *         or UINT64_MAX if the pipeline was already closed.
+     */
+    uint64_t submit(Request req);
+
+    /// Stop accepting new transactions. In-flight ones keep going.
+    void close();
+
+    /**
+     * Close the pipeline and wait until every submitted transaction is done.
+     * @return The results of every submitted transaction, in submission order.
+     */
+    std::vector<Result> wait();
+};
+
+#endif  // TXPIPELINE_H
@@ -0,0 +1,91 @@
+#ifndef TXRECORD_H
+#define TXRECORD_H
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include <nlohmann/json.hpp>
+
+#include <web3cpp/devcore/Address.h>
+#include <web3cpp/devcore/Common.h>
+#include <web3cpp/devcore/CommonData.h>
+#include <web3cpp/devcore/RLP.h>
+#include <web3cpp/ethcore/Common.h>
+#include <web3cpp/ethcore/TransactionBase.h>
+#include <web3cpp/Utils.h>
+
+using json = nlohmann::ordered_json;
+
+/**
+ * Compact record for a transaction in an account's history.
+ * Stored as an RLP list: `[version, flags, from, unixDate, blockNumber, rawTx]`.
+ * Every transaction field (value, gas, data, signature...) is kept raw
+ * inside the signed transaction itself, so only the data that can't be
+ * cheaply derived from it (the recovered sender and the local metadata)
+ * is stored next to it. Human-readable fields are only built by toJson().
+ * Records written before this format (JSON strings) are still readable,
+ * see fromStored().
+ */
+
+class TxRecord {
+  public:
+    static const unsigned int version = 1;  ///< Current record format version.
+
+    dev::bytes raw;                   ///< The signed transaction.
+    dev::Address from;                ///< Sender recovered from the signature. Zero if unsigned.
+    uint64_t unixDate = 0;            ///< When the transaction was saved, in seconds since the epoch.
+    uint64_t blockNumber = 0;         ///< Block the transaction was mined in. 0 if unknown.
+    bool confirmed = false;           ///< Indicates the transaction was mined.
+    bool invalid = false;             ///< Indicates the transaction was rejected.
+
+    /**
+     * Build a record from a signed transaction, saved now.
+     * This is the only place the sender is recovered (ecrecover).
+     * @param signedTx The raw transaction signature, with or without "0x".
+     * @return The record.
+     * @throw std::exception if the transaction can't be decoded.
+     */
+    static TxRecord fromSignedTx(const std::string& signedTx);
+
+    /**
+     * Build a record from a legacy JSON record (from Utils::decodeRawTransaction()).
+     * @param &legacy The JSON record.
+     * @param &out The record.
+     * @return `true` on success, `false` if the JSON isn't a valid record.
+     */
+    static bool fromJson(const json& legacy, TxRecord& out);
+
+    /**
+     * Read a record from its stored value, in either format.
+     * @param stored The stored value (RLP record or legacy JSON string).
+     * @param &out The record.
+     * @return `true` on success, `false` if the value isn't a valid record.
+     */
+    static bool fromStored(std::string_view stored, TxRecord& out);
+
+    /// Check if a stored value is in the legacy JSON format.
+    static bool isLegacy(std::string_view stored) { return !stored.empty() && stored[0] == '{'; }
+
+    /// Serialize the record for storage.
+    std::string encode() const;
+
+    /// Decode the signed transaction. Doesn't recover the sender.
+    dev::eth::TransactionBase tx() const;
+
+    /// Get the key the record is stored under (same as the legacy "hash" field).
+    std::string key() const;
+
+    /**
+     * Build the human-readable JSON for the record, with the same fields
+     * as Utils::decodeRawTransaction() (plus the block number, if known).
+     * @return The JSON record.
+     */
+    json toJson() const;
+};
+
+#endif  // TXRECORD_H
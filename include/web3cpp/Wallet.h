@@ -1,11 +1,15 @@
 #ifndef WALLET_H
 #define WALLET_H
 
+#include <atomic>
 #include <chrono>
 #include <ctime>
 #include <future>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "Utils.h"
@@ -25,9 +29,11 @@
 #include <web3cpp/Error.h>
 #include <web3cpp/Account.h>
 #include <web3cpp/DB.h>
+#include <web3cpp/Eth.h>
 #include <web3cpp/Cipher.h>
 #include <web3cpp/Bip39.h>
 #include <web3cpp/Provider.h>
+#include <web3cpp/TimerService.h>
 
 using json = nlohmann::ordered_json;
 
@@ -44,13 +50,55 @@ class Wallet {
     int passIterations = 100000;                        ///< Number of PBKDF2 iterations to hash+salt the wallet's password.
     boost::filesystem::path path;                       ///< The wallet's folder path.
     const std::unique_ptr<Provider>& provider;          ///< Pointer to Web3::defaultProvider.
-    Database infoDB;                                    ///< The wallet's information database.
-    Database accountDB;                                 ///< The wallet's account database.
+    Database walletDB;                                  ///< The wallet's database. Opened once and partitioned by key prefix.
+    Database infoDB;                                    ///< Partition of walletDB for the wallet's information.
+    Database accountDB;                                 ///< Partition of walletDB for the wallet's accounts.
     bool _isLoaded;                                     ///< Indicates the wallet is properly loaded.
     std::string _password;                              ///< In-memory plain text copy of the wallet's password. Set by the user when they want to "remember" the password.
     std::time_t _passEnd;                               ///< Timestamp after which the password will be "forgotten"/erased from memory.
-    std::thread _passThread;                            ///< Thread object that runs passHandler().
-    std::vector<std::unique_ptr<Account>> accountList;  ///< List of accounts loaded in this wallet. vector is modified on constructor (load from DB) and createNew 
+    TimerService::TimerId _passTimer = 0;               ///< Timer that "forgets" the password when it expires.
+    uint64_t _passGen = 0;                              ///< Bumped on every store/clear, so stale timers don't touch a newer password.
+    mutable std::mutex passLock;                        ///< Mutex for managing read/write access to the stored password.
+    std::unordered_map<dev::Address, std::unique_ptr<Account>> accountList;  ///< Accounts loaded in this wallet, indexed by address. Modified on loadWallet() (load from DB), importPrivKey() and deleteAccount().
+    std::shared_ptr<HistoryWriter> historyWriter;       ///< Write-behind queue for the accounts' histories, if enabled.
+
+    /// Decrypted key kept in the session cache.
+    struct SessionKey {
+      dev::Secret secret;                               ///< Decrypted private key. Zeroed when destroyed.
+      std::chrono::steady_clock::time_point expiry;     ///< When the key should be dropped.
+      TimerService::TimerId timer = 0;                  ///< Timer that drops the key when it expires.
+      uint64_t gen = 0;                                 ///< Generation of the entry, so a stale timer doesn't drop a newer key.
+    };
+    std::unordered_map<dev::Address, SessionKey> sessionKeys; ///< Session cache of decrypted keys, per address.
+    unsigned int sessionTTL = 0;                        ///< Seconds each decrypted key is kept. 0 means the session is locked.
+    dev::h256 sessionSalt;                              ///< Salt for the session password hash.
+    dev::SecureFixedHash<32> sessionPassHash;           ///< Fast hash of the password the session was unlocked with.
+    uint64_t sessionHits = 0;                           ///< Number of keys served from the session cache.
+    uint64_t sessionMisses = 0;                         ///< Number of keys decrypted while the session was unlocked.
+    uint64_t sessionGen = 0;                            ///< Last generation handed out to a session cache entry.
+    mutable std::mutex sessionLock;                     ///< Mutex for managing read/write access to the session cache.
+
+    /**
+     * Hash a password with the session salt. Cheap on purpose, as it's only
+     * used to check the password on session cache hits, after the password
+     * was already fully checked when unlocking the session.
+     * @param &password The password to hash.
+     * @return The salted password hash.
+     */
+    dev::SecureFixedHash<32> sessionHash(const std::string& password) const;
+
+    /**
+     * Decrypt the keys of many accounts at once, each only once.
+     * @param &addresses The addresses of the accounts, duplicates allowed.
+     * @param &password The wallet's password.
+     * @param threads Number of worker threads.
+     * @return A map with the decrypted key of each distinct address.
+     *         Addresses that failed to decrypt are left out.
+     */
+    std::unordered_map<dev::Address, dev::Secret> decryptSecrets(
+      const std::vector<std::string>& addresses, const std::string& password,
+      unsigned int threads
+    );
 
     /// Get the wallet's "wallet.info" file path. Usually used to check if the wallet exists.
     boost::filesystem::path walletExistsPath() { return path.string() + "/wallet.info"; };
@@ -58,26 +106,63 @@ class Wallet {
     /// Get the wallet's root folder path.
     boost::filesystem::path walletFolder() { return path.string() + "/wallet"; };
 
-    /// Get the wallet's account database folder path.
+    /// Get the legacy (one LevelDB per account) account database folder path.
     boost::filesystem::path accountsFolder() { return path.string() + "/wallet/accounts"; };
 
     /// Get the wallet's seed phrase file path.
     boost::filesystem::path seedPhraseFile() { return path.string() + "/wallet/seed"; };
 
-    /// Get the wallet's transaction database root folder path.
+    /// Get the legacy (one LevelDB per account) transaction database root folder path.
     boost::filesystem::path transactionsFolder() { return path.string() + "/wallet/transactions"; }
 
-    /// Threaded function that handles the logic of storing/clearing password to/from memory.
-    void passHandler() {
-      while (true) {
-        std::time_t now = std::time(nullptr);
-        if (now >= this->_passEnd) break;
-        std::this_thread::sleep_for(std::chrono::seconds(1));
-      }
-      this->_password.clear();
-      this->_passEnd = 0;
-      return;
-    }
+    /**
+     * Get the partition of walletDB that holds an account's transactions.
+     * @param &address The address of the account, as stored in accountDB.
+     * @return The account's history partition.
+     */
+    Database historyDB(const std::string& address) const { return walletDB.partition("tx/" + address + "/"); }
+
+    /**
+     * Move the contents of the legacy layout (separate LevelDB folders for
+     * the wallet info, the accounts and every account's transactions) into
+     * walletDB, removing each legacy folder once it's copied.
+     * Safe to interrupt, as copying a folder again is harmless.
+     */
+    void migrateLegacyStorage();
+
+    /**
+     * Convert every transaction stored as JSON (the legacy history format)
+     * into a compact TxRecord, and build the index entries (see TxIndex)
+     * of every transaction, in batches. Marked as done in infoDB
+     * ("historyFormat"), so it only runs once. Safe to interrupt, as
+     * writing a record and its entries again is harmless.
+     */
+    void convertLegacyHistory();
+
+    /**
+     * Convert an address string to the key used in accountList.
+     * @param &address The address string, with or without "0x", in any case.
+     * @return The address, or an empty (zero) address if it's invalid.
+     */
+    static dev::Address accountKey(const std::string& address);
+
+    /// Cancel the password expiry timer, if any. Waits for it if it's running.
+    void cancelPassTimer();
+
+    /**
+     * Drop a key from the session cache when it expires. Called by its timer.
+     * @param &key The address of the account.
+     * @param gen The generation of the entry the timer was scheduled for.
+     */
+    void evictSessionKey(const dev::Address& key, uint64_t gen);
+
+    /**
+     * Drop every key from the session cache and cancel their timers.
+     * Timers are cancelled after sessionLock is released, as a running one
+     * waits for it.
+     * @param &lock A lock already holding sessionLock. Released on return.
+     */
+    void clearSessionKeys(std::unique_lock<std::mutex>& lock);
 
     /**
      * Creates a new wallet.
@@ -90,6 +175,21 @@ class Wallet {
      */
     bool createNewWallet(const std::string& password, Error &error);
 
+    /**
+     * Decrypt the private key of one of the wallet's accounts.
+     * This runs the full key derivation (scrypt), unless the session is
+     * unlocked and the key is still in the session cache.
+     * @param address The address of the account.
+     * @param password The wallet's password.
+     * @param &err Error object.
+     * @return The account's private key, or an empty key on failure.
+     */
+    dev::Secret decryptSecret(
+      const std::string& address, const std::string& password, Error &err
+    );
+
+    friend class TxPipeline;
+
   public:
     /**
      * Constructor.
@@ -98,9 +198,13 @@ class Wallet {
      */
     Wallet(const std::unique_ptr<Provider>& _provider, boost::filesystem::path _path)
       : provider(_provider), path(_path),
-        infoDB("walletInfo", walletFolder()),
-        accountDB("accounts", walletFolder())
-    {};
+        walletDB("store", walletFolder()),
+        infoDB(walletDB.partition("info/")),
+        accountDB(walletDB.partition("accounts/"))
+    { migrateLegacyStorage(); };
+
+    /// Destructor. Cancels the password expiry timer.
+    ~Wallet();
 
     const std::unique_ptr<Provider>& getProvider() const { return this->provider; } ///< Getter for provider.
 
@@ -217,7 +321,22 @@ class Wallet {
     dev::eth::TransactionSkeleton buildTransaction(
       std::string from, std::string to, BigNumber value,
       BigNumber gasLimit, BigNumber gasPrice, std::string dataHex,
-      int nonce, Error &error, bool creation = false
+      uint64_t nonce, Error &error, bool creation = false
+    );
+
+    /**
+     * Build a transaction from user data, taking the nonce from the
+     * `from` account's local nonce tracker instead of the network.
+     * The nonce is reserved as pending until the transaction is sent,
+     * and released back on a failed send. Same parameters as the overload
+     * above, except for `nonce`.
+     * @return A struct filled with data for the transaction, ready to be signed,
+     *         or an empty/incomplete struct on failure.
+     */
+    dev::eth::TransactionSkeleton buildTransaction(
+      std::string from, std::string to, BigNumber value,
+      BigNumber gasLimit, BigNumber gasPrice, std::string dataHex,
+      Error &error, bool creation = false
     );
 
     /**
@@ -231,8 +350,42 @@ class Wallet {
       dev::eth::TransactionSkeleton txObj, std::string password, Error &err
     );
 
+    /**
+     * Sign many built transactions at once.
+     * Each distinct `from` key is decrypted only once for the whole batch,
+     * and signing runs in parallel over a pool of worker threads.
+     * @param &txObjs The transaction structs returned from buildTransaction().
+     * @param &password The wallet's password.
+     * @param &err Error object. Set to the first error found, if any.
+     * @param threads (optional) Number of worker threads. Defaults to 0 (one per CPU core).
+     * @return The raw transaction signatures, in the same order as `txObjs`.
+     *         Transactions that failed to sign get an empty string.
+     */
+    std::vector<std::string> signTransactions(
+      const std::vector<dev::eth::TransactionSkeleton>& txObjs,
+      const std::string& password, Error &err, unsigned int threads = 0
+    );
+
+    /**
+     * Sign many data strings as "Ethereum Signed Messages" at once,
+     * same as sign(). Each distinct key is decrypted only once for the
+     * whole batch, and signing runs in parallel over a pool of worker threads.
+     * @param &messages A list of address and data pairs to be signed.
+     * @param &password The wallet's password.
+     * @param &err Error object. Set to the first error found, if any.
+     * @param threads (optional) Number of worker threads. Defaults to 0 (one per CPU core).
+     * @return The hex signatures, in the same order as `messages`.
+     *         Messages that failed to sign get an empty string.
+     */
+    std::vector<std::string> signMessages(
+      const std::vector<std::pair<std::string, std::string>>& messages,
+      const std::string& password, Error &err, unsigned int threads = 0
+    );
+
     /**
      * Send/broadcast a signed transaction to the blockchain.
+     * If the sender is an account from this wallet, its nonce tracker is
+     * updated with the result (linked to the hash on success, released on failure).
      * @param signedTx The raw transaction signature returned from signTransaction().
      * @param &err Error object.
      * @return A JSON object with the send results (either "result" or "error")
@@ -248,7 +401,35 @@ class Wallet {
      */
     void storePassword(const std::string& password, unsigned int seconds = 0);
 
-    void clearPassword(); ///< Clear the wallet's password from memory.
+    void clearPassword(); ///< Clear the wallet's password from memory. Also locks the session.
+
+    /**
+     * Unlock a signing session (opt-in). While unlocked, each account's key
+     * is decrypted once and kept in memory (in zeroed-on-free secure types)
+     * for `ttlSeconds`, so signing skips the key derivation on cache hits.
+     * Each key is wiped by a timer as soon as it expires, even if it's never used again.
+     * Calls with a different password than the one used to unlock still fail.
+     * @param &password The wallet's password.
+     * @param ttlSeconds How long each decrypted key is kept, in seconds.
+     * @param &err Error object.
+     * @return `true` if the session was unlocked, `false` otherwise.
+     */
+    bool unlockSession(const std::string& password, unsigned int ttlSeconds, Error &err);
+
+    /// Lock the signing session, dropping every cached key.
+    void lockSession();
+
+    /// Check if the signing session is unlocked.
+    bool isSessionUnlocked() const;
+
+    /// Get the number of decrypted keys held in the session cache.
+    std::size_t sessionKeyCount() const;
+
+    /**
+     * Get the session cache statistics since the last unlockSession().
+     * @return A pair with the number of cache hits and misses, respectively.
+     */
+    std::pair<uint64_t, uint64_t> sessionStats() const;
 
     /**
      * Check if the wallet has a password stored in memory.
@@ -256,9 +437,38 @@ class Wallet {
      */
     bool isPasswordStored();
 
+    /**
+     * Sync the nonces of every account in the wallet with the network,
+     * using batched `eth_getTransactionCount` requests instead of one
+     * request per account. This is the only place nonces are synced for
+     * Account::nonce(), which never makes a request of its own. Accounts
+     * that aren't synced here fetch their nonce when their first
+     * transaction is built.
+     * @param &err Error object.
+     * @param batchSize (optional) The maximum number of requests per batch. Defaults to 100.
+     * @return `true` if every account was synced, `false` otherwise.
+     */
+    std::future<bool> refreshNonces(Error &err, unsigned int batchSize = 100);
+
+    /**
+     * Turn write-behind mode on or off for every account's history.
+     * When on, Account::saveTxToHistory() only queues the transaction, and
+     * a background worker decodes and writes queued transactions in batches.
+     * Turning it off writes everything still queued first.
+     * @param enable `true` to queue history writes, `false` to write them synchronously.
+     */
+    void setHistoryWriteBehind(bool enable);
+
+    /**
+     * Wait until every history write queued so far is written and synced
+     * to disk. Does nothing if write-behind mode is off.
+     * @return `true` on success, `false` if any queued write failed.
+     */
+    bool flushHistory();
+
     /**
      * Get the accounts stored in the wallet.
-     * @return A list of addresses from the wallet.
+     * @return A list of addresses from the wallet, sorted.
      */
     std::vector<std::string> getAccounts();
 
@@ -0,0 +1,978 @@
+#include <web3cpp/ABI.h>
+
+namespace {
+  /// Write a uint256 into a zeroed 32-byte word, big-endian.
+  void putUint(uint8_t* word, const BigNumber& num) {
+    // Copy the limbs directly instead of shifting the whole number per byte
+    using limb = boost::multiprecision::limb_type;
+    const limb* limbs = num.backend().limbs();
+    for (size_t i = 0; i < num.backend().size(); i++) {
+      uint8_t* end = word + 32 - (i * sizeof(limb));
+      limb l = limbs[i];
+      for (size_t b = 1; b <= sizeof(limb) && l != 0; b++, l >>= 8) {
+        *(end - b) = static_cast<uint8_t>(l);
+      }
+    }
+  }
+
+  /// Write a size into a zeroed 32-byte word, big-endian.
+  void putSize(uint8_t* word, uint64_t num) {
+    for (int i = 31; i >= 24 && num != 0; i--, num >>= 8) word[i] = static_cast<uint8_t>(num);
+  }
+
+  /// Get the value of a hex digit. Non-hex characters count as 0.
+  uint8_t nibble(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return 0;
+  }
+
+  /// Strip the "0x" prefix from a hex string, if any.
+  std::string_view stripPrefix(std::string_view hex) {
+    if (hex.size() >= 2 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) hex.remove_prefix(2);
+    return hex;
+  }
+
+  /**
+   * Decode a hex string (without "0x") into a buffer.
+   * Odd lengths are read as if they had a leading zero ("aaa" = "0aaa").
+   * @param hex The hex string.
+   * @param *out The buffer. Has to fit `(hex.size() + 1) / 2` bytes.
+   */
+  void putHex(std::string_view hex, uint8_t* out) {
+    size_t i = 0;
+    if (hex.size() % 2 != 0) *out++ = nibble(hex[i++]);
+    for (; i < hex.size(); i += 2) *out++ = (nibble(hex[i]) << 4) | nibble(hex[i + 1]);
+  }
+
+  /// Write an address (hex string, with or without "0x") into a zeroed 32-byte word.
+  void putAddress(uint8_t* word, std::string_view add) {
+    add = stripPrefix(add);
+    if (add.size() > 40) add = add.substr(add.size() - 40);
+    putHex(add, word + 32 - ((add.size() + 1) / 2));
+  }
+
+  /// Check if a bool string is true ("true" or "1").
+  bool isTrue(std::string_view b) { return (b == "true" || b == "1"); }
+
+  /// Get the number of padded 32-byte words needed for a byte string.
+  size_t wordsFor(size_t size) { return (size + 31) / 32; }
+
+  /// Write a signed decimal number string into a zeroed 32-byte word, in two's complement.
+  void putInt(uint8_t* word, std::string_view num) {
+    bool negative = (!num.empty() && num[0] == '-');
+    if (negative) num.remove_prefix(1);
+    BigNumber abs = ABI::parseUint(num);
+    putUint(word, (negative) ? BigNumber(~abs + 1) : abs);
+  }
+
+  /// Get the total head size of a list of types, in bytes.
+  size_t headsOf(const std::vector<ABI::Type>& types) {
+    size_t ret = 0;
+    for (const ABI::Type& t : types) ret += t.headSize();
+    return ret;
+  }
+
+  /**
+   * Parse a signed decimal number string and check that it fits in an intN.
+   * @param num The number string, with a leading "-" if negative.
+   * @param bits The size of the int, in bits.
+   * @param &out Set to the number's 32-byte word (two's complement if negative).
+   * @return `false` if the string isn't a number or the number doesn't fit.
+   */
+  bool parseInt(std::string_view num, unsigned int bits, BigNumber& out) {
+    bool negative = (!num.empty() && num[0] == '-');
+    if (negative) num.remove_prefix(1);
+    BigNumber abs;
+    if (num.empty() || !ABI::parseUint(num, 256, abs)) return false;
+    BigNumber limit = BigNumber(1) << (bits - 1);
+    if ((negative) ? abs > limit : abs >= limit) return false;
+    out = (negative) ? BigNumber(~abs + 1) : abs;
+    return true;
+  }
+
+  /// Map a scalar's error code to the code for an array of it, as Solidity::checkType() does for "T[]".
+  uint64_t arrayCode(uint64_t code) {
+    switch (code) {
+      case 25: case 42: return 20;  // ABI Invalid Uint256 Array
+      case 26: return 21;           // ABI Invalid Address Array
+      case 27: return 22;           // ABI Invalid Boolean Array
+      case 28: return 23;           // ABI Invalid Bytes Array
+      case 29: return 24;           // ABI Invalid String Array
+      default: return code;
+    }
+  }
+
+  /// Check if an array or tuple value is a JSON array of the right length.
+  bool hasLength(const ABI::Type& type, const json& value) {
+    bool same = (type.kind == ABI::Type::Array);
+    size_t length = (same) ? type.length : type.components.size();
+    // Dynamic arrays are the only ones that can have any length
+    return (value.is_array() && ((same && length == 0) || value.size() == length));
+  }
+
+  /**
+   * Check a value of any type but arrays and tuples, parsing it if it's a number.
+   * @param &type The type of the value.
+   * @param &value The value (see ABI::Encoder::add()).
+   * @param &num Set to the 32-byte word of Uint and Int values, so they're only parsed once.
+   * @return The error code, or 0 if the value is valid.
+   */
+  uint64_t checkScalar(const ABI::Type& type, const json& value, BigNumber& num) {
+    using ABI::Type;
+    if (!value.is_string()) {
+      switch (type.kind) {
+        case Type::Uint: return 25;     // ABI Invalid Uint256
+        case Type::Int: return 42;      // ABI Invalid Int
+        case Type::Address: return 26;  // ABI Invalid Address
+        case Type::Bool: return 27;     // ABI Invalid Boolean
+        case Type::String: return 29;   // ABI Invalid String
+        default: return 28;             // ABI Invalid Bytes
+      }
+    }
+    const std::string& it = value.get_ref<const std::string&>();
+    switch (type.kind) {
+      case Type::Uint: return (ABI::parseUint(it, type.size, num)) ? 0 : 25;
+      case Type::Int: return (parseInt(it, type.size, num)) ? 0 : 42;
+      case Type::Address: return (Utils::isAddress(it)) ? 0 : 26;
+      case Type::Bool: return (it == "0" || it == "1" || it == "true" || it == "false") ? 0 : 27;
+      case Type::FixedBytes: case Type::Function: {
+        size_t digits = it.size() - ((Utils::isHexStrict(it)) ? 2 : 0);
+        return (Utils::isHex(it) && digits <= 2 * type.size) ? 0 : 28;
+      }
+      case Type::Bytes: return (Utils::isHex(it)) ? 0 : 28;
+      case Type::String: return 0;
+      default: return 31;  // ABI Unsupported Or Invalid Type
+    }
+  }
+}
+
+BigNumber ABI::parseUint(std::string_view num) {
+  static const uint64_t pow10[] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull,
+    100000000ull, 1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull,
+    10000000000000ull, 100000000000000ull, 1000000000000000ull, 10000000000000000ull,
+    100000000000000000ull, 1000000000000000000ull, 10000000000000000000ull
+  };
+  BigNumber ret = 0;
+  while (!num.empty()) {
+    size_t take = std::min<size_t>(num.size(), 19);
+    uint64_t chunk = 0;
+    for (size_t i = 0; i < take; i++) chunk = chunk * 10 + (num[i] - '0');
+    ret = ret * pow10[take] + chunk;
+    num.remove_prefix(take);
+  }
+  return ret;
+}
+
+bool ABI::parseUint(std::string_view num, unsigned int bits, BigNumber& out) {
+  static const std::string_view max =  // 2^256 - 1
+    "115792089237316195423570985008687907853269984665640564039457584007913129639935";
+  if (num.find_first_not_of("0123456789") != std::string_view::npos) return false;
+  size_t digits = num.find_first_not_of('0');
+  num.remove_prefix((digits == std::string_view::npos) ? num.size() : digits);
+  // Compared as strings, so a number that would wrap around is never parsed
+  if (num.size() > max.size() || (num.size() == max.size() && num > max)) return false;
+  out = parseUint(num);
+  return (bits >= 256 || (out >> bits) == 0);
+}
+
+uint64_t ABI::check(const Type& type, const json& value) {
+  if (type.kind != Type::Array && type.kind != Type::Tuple) {
+    BigNumber num;
+    return checkScalar(type, value, num);
+  }
+  if (!hasLength(type, value)) return 19;  // ABI Invalid JSON Array
+  bool same = (type.kind == Type::Array);
+  for (size_t i = 0; i < value.size(); i++) {
+    uint64_t code = check(type.components[(same) ? 0 : i], value[i]);
+    if (code != 0) return (same) ? arrayCode(code) : code;
+  }
+  return 0;
+}
+
+dev::bytes ABI::selector(const std::string& func) {
+  dev::h256 hash = dev::sha3(func);
+  return dev::bytes(hash.data(), hash.data() + 4);
+}
+
+ABI::Encoder::Encoder(size_t args, dev::bytesConstRef selector)
+  : out(own), heads(32 * args)
+{
+  this->init(selector);
+}
+
+ABI::Encoder::Encoder(dev::bytes& buffer, size_t args, dev::bytesConstRef selector)
+  : out(buffer), heads(32 * args)
+{
+  this->init(selector);
+}
+
+ABI::Encoder::Encoder(const std::vector<Type>& types, dev::bytesConstRef selector)
+  : out(own), heads(headsOf(types))
+{
+  this->init(selector);
+}
+
+ABI::Encoder::Encoder(dev::bytes& buffer, const std::vector<Type>& types, dev::bytesConstRef selector)
+  : out(buffer), heads(headsOf(types))
+{
+  this->init(selector);
+}
+
+ABI::Encoder::Encoder(dev::bytes& buffer, const Function& func)
+  : out(buffer), heads(func.headSize)
+{
+  this->init(&func.selector);
+}
+
+void ABI::Encoder::init(dev::bytesConstRef selector) {
+  this->out.clear();
+  this->out.insert(this->out.end(), selector.begin(), selector.end());
+  this->base = this->out.size();
+  this->out.resize(this->base + this->heads, 0);
+}
+
+uint8_t* ABI::Encoder::head() {
+  // Writes past the declared arguments go to a scratch word
+  static thread_local uint8_t scratch[32];
+  size_t pos = this->next;
+  this->next += 32;
+  if (this->next > this->heads) return scratch;
+  return this->at(this->base + pos);
+}
+
+size_t ABI::Encoder::grow(size_t words) {
+  size_t pos = this->out.size();
+  this->out.resize(pos + (32 * words), 0);
+  return pos;
+}
+
+void ABI::Encoder::headOffset() {
+  putSize(this->head(), this->out.size() - this->base);
+}
+
+void ABI::Encoder::appendBlob(const uint8_t* data, size_t size) {
+  size_t pos = this->grow(1 + wordsFor(size));
+  putSize(this->at(pos), size);
+  if (size > 0) std::copy(data, data + size, this->at(pos + 32));
+}
+
+void ABI::Encoder::appendHexBlob(std::string_view hex) {
+  hex = stripPrefix(hex);
+  size_t size = (hex.size() + 1) / 2;
+  size_t pos = this->grow(1 + wordsFor(size));
+  putSize(this->at(pos), size);
+  putHex(hex, this->at(pos + 32));
+}
+
+void ABI::Encoder::addUint(const BigNumber& num) {
+  putUint(this->head(), num);
+}
+
+void ABI::Encoder::addAddress(const dev::Address& add) {
+  std::copy(add.data(), add.data() + 20, this->head() + 12);
+}
+
+void ABI::Encoder::addBool(bool b) {
+  this->head()[31] = b ? 1 : 0;
+}
+
+void ABI::Encoder::addBytes(dev::bytesConstRef data) {
+  this->headOffset();
+  this->appendBlob(data.data(), data.size());
+}
+
+void ABI::Encoder::addString(std::string_view str) {
+  this->headOffset();
+  this->appendBlob(reinterpret_cast<const uint8_t*>(str.data()), str.size());
+}
+
+void ABI::Encoder::addUintArray(const std::vector<BigNumber>& numV) {
+  this->headOffset();
+  size_t pos = this->grow(1 + numV.size());
+  putSize(this->at(pos), numV.size());
+  for (size_t i = 0; i < numV.size(); i++) putUint(this->at(pos + 32 * (i + 1)), numV[i]);
+}
+
+void ABI::Encoder::addAddressArray(const std::vector<dev::Address>& addV) {
+  this->headOffset();
+  size_t pos = this->grow(1 + addV.size());
+  putSize(this->at(pos), addV.size());
+  for (size_t i = 0; i < addV.size(); i++) {
+    std::copy(addV[i].data(), addV[i].data() + 20, this->at(pos + 32 * (i + 1) + 12));
+  }
+}
+
+void ABI::Encoder::addBoolArray(const std::vector<bool>& bV) {
+  this->headOffset();
+  size_t pos = this->grow(1 + bV.size());
+  putSize(this->at(pos), bV.size());
+  for (size_t i = 0; i < bV.size(); i++) this->at(pos + 32 * (i + 1))[31] = bV[i] ? 1 : 0;
+}
+
+void ABI::Encoder::addBytesArray(const std::vector<dev::bytes>& dataV) {
+  this->headOffset();
+  // Count, then the offset of each item (relative to the first offset), then the items
+  size_t pos = this->grow(1 + dataV.size());
+  putSize(this->at(pos), dataV.size());
+  for (size_t i = 0; i < dataV.size(); i++) {
+    putSize(this->at(pos + 32 * (i + 1)), this->out.size() - (pos + 32));
+    this->appendBlob(dataV[i].data(), dataV[i].size());
+  }
+}
+
+void ABI::Encoder::addStringArray(const std::vector<std::string>& strV) {
+  this->headOffset();
+  size_t pos = this->grow(1 + strV.size());
+  putSize(this->at(pos), strV.size());
+  for (size_t i = 0; i < strV.size(); i++) {
+    putSize(this->at(pos + 32 * (i + 1)), this->out.size() - (pos + 32));
+    this->appendBlob(reinterpret_cast<const uint8_t*>(strV[i].data()), strV[i].size());
+  }
+}
+
+bool ABI::Encoder::add(const std::string& type, const json& value) {
+  if (type == "uint256") {
+    putUint(this->head(), parseUint(value.get_ref<const std::string&>()));
+  } else if (type == "address") {
+    putAddress(this->head(), value.get_ref<const std::string&>());
+  } else if (type == "bool") {
+    this->addBool(isTrue(value.get_ref<const std::string&>()));
+  } else if (type == "bytes") {
+    this->headOffset();
+    this->appendHexBlob(value.get_ref<const std::string&>());
+  } else if (type == "string") {
+    this->addString(value.get_ref<const std::string&>());
+  } else if (
+    type == "uint256[]" || type == "address[]" || type == "bool[]" ||
+    type == "bytes[]" || type == "string[]"
+  ) {
+    this->headOffset();
+    size_t pos = this->grow(1 + value.size());
+    putSize(this->at(pos), value.size());
+    size_t i = 0;
+    for (const json& item : value) {
+      const std::string& it = item.get_ref<const std::string&>();
+      size_t slot = pos + 32 * (++i);
+      if (type == "uint256[]") {
+        putUint(this->at(slot), parseUint(it));
+      } else if (type == "address[]") {
+        putAddress(this->at(slot), it);
+      } else if (type == "bool[]") {
+        this->at(slot)[31] = isTrue(it) ? 1 : 0;
+      } else {
+        putSize(this->at(slot), this->out.size() - (pos + 32));
+        if (type == "bytes[]") {
+          this->appendHexBlob(it);
+        } else {
+          this->appendBlob(reinterpret_cast<const uint8_t*>(it.data()), it.size());
+        }
+      }
+    }
+  } else {
+    Type t;
+    if (!Type::parse(type, json::array(), t)) return false;
+    this->add(t, value);
+  }
+  return true;
+}
+
+uint64_t ABI::Encoder::encode(
+  const Type& type, const json& value, size_t pos, size_t start, bool check
+) {
+  BigNumber num;
+  if (check && type.kind != Type::Array && type.kind != Type::Tuple) {
+    uint64_t code = checkScalar(type, value, num);
+    if (code != 0) return code;
+  }
+  switch (type.kind) {
+    case Type::Uint:
+      putUint(this->at(pos), (check) ? num : parseUint(value.get_ref<const std::string&>()));
+      break;
+    case Type::Int:
+      if (check) putUint(this->at(pos), num); else putInt(this->at(pos), value.get_ref<const std::string&>());
+      break;
+    case Type::Address:
+      putAddress(this->at(pos), value.get_ref<const std::string&>());
+      break;
+    case Type::Bool:
+      this->at(pos)[31] = isTrue(value.get_ref<const std::string&>()) ? 1 : 0;
+      break;
+    case Type::FixedBytes: case Type::Function: {
+      // Left aligned, unlike every other static type
+      std::string_view hex = stripPrefix(value.get_ref<const std::string&>());
+      putHex(hex.substr(0, 2 * type.size), this->at(pos));
+      break;
+    }
+    case Type::Bytes:
+      putSize(this->at(pos), this->out.size() - start);
+      this->appendHexBlob(value.get_ref<const std::string&>());
+      break;
+    case Type::String: {
+      const std::string& str = value.get_ref<const std::string&>();
+      putSize(this->at(pos), this->out.size() - start);
+      this->appendBlob(reinterpret_cast<const uint8_t*>(str.data()), str.size());
+      break;
+    }
+    case Type::Array: case Type::Tuple: {
+      if (check && !hasLength(type, value)) return 19;  // ABI Invalid JSON Array
+      bool same = (type.kind == Type::Array);
+      if (type.isDynamic()) {
+        putSize(this->at(pos), this->out.size() - start);
+        if (same && type.length == 0) putSize(this->at(this->grow(1)), value.size());
+        uint64_t code = this->encodeSeq(type.components.data(), value, same, check);
+        return (same) ? arrayCode(code) : code;
+      }
+      // Static arrays and tuples are inlined in the enclosing head
+      for (size_t i = 0; i < value.size(); i++) {
+        const Type& t = type.components[(same) ? 0 : i];
+        uint64_t code = this->encode(t, value[i], pos, start, check);
+        if (code != 0) return (same) ? arrayCode(code) : code;
+        pos += t.headSize();
+      }
+      break;
+    }
+  }
+  return 0;
+}
+
+uint64_t ABI::Encoder::encodeSeq(const Type* types, const json& values, bool same, bool check) {
+  size_t size = 0;
+  for (size_t i = 0; i < values.size(); i++) size += types[(same) ? 0 : i].headSize();
+  size_t start = this->grow(size / 32);
+  size_t pos = start;
+  for (size_t i = 0; i < values.size(); i++) {
+    const Type& t = types[(same) ? 0 : i];
+    uint64_t code = this->encode(t, values[i], pos, start, check);
+    if (code != 0) return code;
+    pos += t.headSize();
+  }
+  return 0;
+}
+
+void ABI::Encoder::add(const Type& type, const json& value) {
+  size_t pos = this->next;
+  this->next += type.headSize();
+  if (this->next > this->heads) return;
+  this->encode(type, value, this->base + pos, this->base, false);
+}
+
+uint64_t ABI::Encoder::addChecked(const Type& type, const json& value) {
+  size_t pos = this->next;
+  this->next += type.headSize();
+  if (this->next > this->heads) return 0;
+  return this->encode(type, value, this->base + pos, this->base, true);
+}
+
+std::string ABI::Encoder::hex() const {
+  return dev::toHexPrefixed(this->out);
+}
+
+namespace {
+  /// Parse a decimal number string made only of digits, up to a limit.
+  bool parseSize(const std::string& str, size_t max, size_t& out) {
+    if (str.empty() || str.size() > 9 || !std::all_of(str.begin(), str.end(), ::isdigit)) return false;
+    out = std::stoul(str);
+    return (out > 0 && out <= max);
+  }
+
+  /**
+   * Read an optional string or boolean member of a JSON ABI entry.
+   * @param &obj The entry.
+   * @param *key The member's name.
+   * @param &out Set to the member's value. Untouched if the member is missing.
+   * @return `false` if the member has the wrong type, `true` otherwise.
+   */
+  template <typename T>
+  bool optional(const json& obj, const char* key, T& out) {
+    auto it = obj.find(key);
+    if (it == obj.end()) return true;
+    if constexpr (std::is_same_v<T, bool>) {
+      if (!it->is_boolean()) return false;
+    } else {
+      if (!it->is_string()) return false;
+    }
+    out = it->template get<T>();
+    return true;
+  }
+
+  /// Read a 32-byte big-endian word as a uint256, eight bytes at a time.
+  BigNumber getUint(const uint8_t* word) {
+    BigNumber ret = 0;
+    for (int i = 0; i < 32; i += 8) {
+      uint64_t chunk = 0;
+      for (int b = 0; b < 8; b++) chunk = (chunk << 8) | word[i + b];
+      ret = (ret << 64) | chunk;
+    }
+    return ret;
+  }
+}
+
+bool ABI::Type::parse(const std::string& type, const json& components, Type& out) {
+  out = Type();
+  // Arrays: the last "[k]" or "[]" is the outermost one
+  if (!type.empty() && type.back() == ']') {
+    size_t open = type.rfind('[');
+    if (open == std::string::npos || open == 0) return false;
+    std::string len = type.substr(open + 1, type.size() - open - 2);
+    Type item;
+    if (!parse(type.substr(0, open), components, item)) return false;
+    out.kind = Array;
+    if (!len.empty() && !parseSize(len, maxLength, out.length)) return false;
+    // Items have to take some space (empty tuples don't), and the size is
+    // checked by division, so a huge nested array can't overflow it
+    if (!item.isDynamic() && item.headSize() == 0) return false;
+    if (out.length > 0 && !item.isDynamic() && out.length > maxHeadSize / item.headSize()) return false;
+    out.components.push_back(std::move(item));
+    return true;
+  }
+  if (type.size() >= 2 && type.front() == '(' && type.back() == ')') {
+    // Canonical tuple, split on the commas that aren't inside a nested tuple
+    out.kind = Tuple;
+    if (type.size() == 2) return true;  // "()"
+    int depth = 0;
+    size_t begin = 1;
+    bool closed = false;
+    for (size_t i = 1; i < type.size(); i++) {
+      if (type[i] == '(') depth++;
+      else if (type[i] == ')' && depth > 0) depth--;
+      else if ((type[i] == ',' && depth == 0) || type[i] == ')') {
+        // Only the last character can close the tuple itself
+        if (type[i] == ')' && i != type.size() - 1) return false;
+        // Every comma and the closing parenthesis need a component before them
+        if (i == begin) return false;
+        Type t;
+        if (!parse(type.substr(begin, i - begin), json::array(), t)) return false;
+        out.components.push_back(std::move(t));
+        out.names.emplace_back();
+        begin = i + 1;
+        closed = (type[i] == ')');
+      }
+    }
+    return (closed && (out.isDynamic() || out.headSize() <= maxHeadSize));
+  }
+  if (type == "tuple") {
+    out.kind = Tuple;
+    if (!components.is_array()) return false;
+    for (const json& component : components) {
+      Type t;
+      std::string name;
+      if (!fromJson(component, t) || !optional(component, "name", name)) return false;
+      out.components.push_back(std::move(t));
+      out.names.push_back(std::move(name));
+    }
+    return (out.isDynamic() || out.headSize() <= maxHeadSize);
+  }
+  if (type == "address") { out.kind = Address; return true; }
+  if (type == "bool") { out.kind = Bool; return true; }
+  if (type == "string") { out.kind = String; return true; }
+  if (type == "bytes") { out.kind = Bytes; return true; }
+  if (type == "function") { out.kind = Function; out.size = 24; return true; }  // address + selector
+  size_t n = 0;
+  if (type.rfind("bytes", 0) == 0) {
+    out.kind = FixedBytes;
+    if (!parseSize(type.substr(5), 32, n)) return false;
+    out.size = n;
+    return true;
+  }
+  bool isUint = (type.rfind("uint", 0) == 0);
+  if (isUint || type.rfind("int", 0) == 0) {
+    out.kind = (isUint) ? Uint : Int;
+    std::string bits = type.substr(isUint ? 4 : 3);
+    if (bits.empty()) return true;  // "uint" and "int" are aliases of the 256-bit ones
+    if (!parseSize(bits, 256, n) || n % 8 != 0) return false;
+    out.size = n;
+    return true;
+  }
+  return false;
+}
+
+bool ABI::Type::fromJson(const json& param, Type& out) {
+  if (!param.is_object() || !param.contains("type") || !param["type"].is_string()) return false;
+  return parse(
+    param["type"].get<std::string>(),
+    (param.contains("components")) ? param["components"] : json::array(), out
+  );
+}
+
+bool ABI::Type::fromJson(const json& params, std::vector<Type>& out) {
+  out.clear();
+  if (!params.is_array()) return false;
+  for (const json& param : params) {
+    Type t;
+    if (!fromJson(param, t)) return false;
+    out.push_back(std::move(t));
+  }
+  return true;
+}
+
+bool ABI::Type::isDynamic() const {
+  switch (this->kind) {
+    case Bytes: case String: return true;
+    case Array: return (this->length == 0 || this->components[0].isDynamic());
+    case Tuple:
+      return std::any_of(this->components.begin(), this->components.end(),
+        [](const Type& t){ return t.isDynamic(); }
+      );
+    default: return false;
+  }
+}
+
+size_t ABI::Type::headSize() const {
+  if (this->isDynamic()) return 32;
+  if (this->kind == Array) return this->length * this->components[0].headSize();
+  if (this->kind == Tuple) {
+    size_t ret = 0;
+    for (const Type& t : this->components) ret += t.headSize();
+    return ret;
+  }
+  return 32;
+}
+
+std::string ABI::Type::canonical() const {
+  switch (this->kind) {
+    case Uint: return "uint" + std::to_string(this->size);
+    case Int: return "int" + std::to_string(this->size);
+    case Address: return "address";
+    case Bool: return "bool";
+    case FixedBytes: return "bytes" + std::to_string(this->size);
+    case Function: return "function";
+    case Bytes: return "bytes";
+    case String: return "string";
+    case Array:
+      return this->components[0].canonical() + "[" +
+        ((this->length > 0) ? std::to_string(this->length) : "") + "]";
+    case Tuple: {
+      std::string ret = "(";
+      for (const Type& t : this->components) ret += t.canonical() + ",";
+      if (ret.back() == ',') ret.pop_back();
+      return ret + ")";
+    }
+  }
+  return "";
+}
+
+bool ABI::Function::fromJson(const json& entry, Function& out) {
+  out = Function();
+  if (!entry.is_object() || !entry.contains("name") || !optional(entry, "name", out.name)) return false;
+  if (!Type::fromJson(entry.value("inputs", json::array()), out.inputs)) return false;
+  if (!Type::fromJson(entry.value("outputs", json::array()), out.outputs)) return false;
+  out.signature = out.name + "(";
+  for (const Type& t : out.inputs) out.signature += t.canonical() + ",";
+  if (out.signature.back() == ',') out.signature.pop_back();
+  out.signature += ")";
+  out.selector = ABI::selector(out.signature);
+  out.headSize = headsOf(out.inputs);
+  return true;
+}
+
+const uint8_t* ABI::Decoder::word(size_t pos) const {
+  if (pos > this->data.size() || this->data.size() - pos < 32) return nullptr;
+  return this->data.data() + pos;
+}
+
+bool ABI::Decoder::readSize(size_t pos, size_t& out) const {
+  const uint8_t* w = this->word(pos);
+  if (w == nullptr) return false;
+  // Anything that doesn't fit in the high bytes can't be a valid offset or length
+  for (int i = 0; i < 24; i++) if (w[i] != 0) return false;
+  uint64_t ret = 0;
+  for (int i = 24; i < 32; i++) ret = (ret << 8) | w[i];
+  if (ret > this->data.size()) return false;
+  out = ret;
+  return true;
+}
+
+bool ABI::Decoder::readUint(size_t pos, BigNumber& out) const {
+  const uint8_t* w = this->word(pos);
+  if (w == nullptr) return false;
+  out = getUint(w);
+  return true;
+}
+
+bool ABI::Decoder::readInt(size_t pos, dev::s256& out) const {
+  BigNumber u;
+  if (!this->readUint(pos, u)) return false;
+  out = dev::u2s(u);
+  return true;
+}
+
+bool ABI::Decoder::readAddress(size_t pos, dev::Address& out) const {
+  const uint8_t* w = this->word(pos);
+  if (w == nullptr) return false;
+  out = dev::Address(dev::bytesConstRef(w + 12, 20));
+  return true;
+}
+
+bool ABI::Decoder::readBool(size_t pos, bool& out) const {
+  const uint8_t* w = this->word(pos);
+  if (w == nullptr) return false;
+  out = (w[31] != 0);
+  return true;
+}
+
+bool ABI::Decoder::readFixedBytes(size_t pos, size_t n, dev::bytesConstRef& out) const {
+  const uint8_t* w = this->word(pos);
+  if (w == nullptr || n > 32) return false;
+  out = dev::bytesConstRef(w, n);
+  return true;
+}
+
+bool ABI::Decoder::readBytes(size_t pos, dev::bytesConstRef& out) const {
+  size_t offset, length;
+  if (!this->readSize(pos, offset) || !this->readSize(offset, length)) return false;
+  if (this->data.size() - (offset + 32) < length) return false;
+  out = this->data.cropped(offset + 32, length);
+  return true;
+}
+
+bool ABI::Decoder::readString(size_t pos, std::string_view& out) const {
+  dev::bytesConstRef bytes;
+  if (!this->readBytes(pos, bytes)) return false;
+  out = std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+  return true;
+}
+
+bool ABI::Decoder::readTuple(size_t pos, Decoder& out) const {
+  size_t offset;
+  if (!this->readSize(pos, offset)) return false;
+  out = Decoder(this->data.cropped(offset));
+  return true;
+}
+
+bool ABI::Decoder::readArray(size_t pos, Decoder& out, size_t& length) const {
+  size_t offset;
+  if (!this->readSize(pos, offset) || !this->readSize(offset, length)) return false;
+  out = Decoder(this->data.cropped(offset + 32));
+  return true;
+}
+
+bool ABI::Decoder::decodeItems(const Type& type, size_t count, json& out) const {
+  out = json::array();
+  // Every item takes at least its head, so bogus counts fail before any work
+  size_t step = type.headSize();
+  if (step == 0 || count > this->data.size() / step) return (count == 0);
+  for (size_t i = 0; i < count; i++) {
+    json item;
+    if (!this->decode(type, i * step, item)) return false;
+    out.push_back(std::move(item));
+  }
+  return true;
+}
+
+bool ABI::Decoder::decode(const Type& type, size_t pos, json& out) const {
+  switch (type.kind) {
+    case Type::Uint: {
+      BigNumber v;
+      if (!this->readUint(pos, v)) return false;
+      out = boost::lexical_cast<std::string>(v);
+      return true;
+    }
+    case Type::Int: {
+      dev::s256 v;
+      if (!this->readInt(pos, v)) return false;
+      out = boost::lexical_cast<std::string>(v);
+      return true;
+    }
+    case Type::Address: {
+      dev::Address v;
+      if (!this->readAddress(pos, v)) return false;
+      out = "0x" + v.hex();
+      return true;
+    }
+    case Type::Bool: {
+      bool v;
+      if (!this->readBool(pos, v)) return false;
+      out = (v) ? "true" : "false";
+      return true;
+    }
+    case Type::FixedBytes: case Type::Function: case Type::Bytes: {
+      dev::bytesConstRef v;
+      bool ok = (type.kind == Type::Bytes)
+        ? this->readBytes(pos, v) : this->readFixedBytes(pos, type.size, v);
+      if (!ok) return false;
+      out = dev::toHexPrefixed(v);
+      return true;
+    }
+    case Type::String: {
+      std::string_view v;
+      if (!this->readString(pos, v)) return false;
+      out = std::string(v);
+      return true;
+    }
+    case Type::Array: {
+      Decoder items = *this;
+      size_t length = type.length;
+      if (type.length == 0) {
+        if (!this->readArray(pos, items, length)) return false;
+      } else if (type.isDynamic()) {
+        if (!this->readTuple(pos, items)) return false;
+      } else {
+        items = Decoder(this->data.cropped(pos));
+      }
+      return items.decodeItems(type.components[0], length, out);
+    }
+    case Type::Tuple: {
+      Decoder fields(this->data.cropped(pos));
+      if (type.isDynamic() && !this->readTuple(pos, fields)) return false;
+      return fields.decode(type.components, out);
+    }
+  }
+  return false;
+}
+
+bool ABI::Decoder::decode(const std::vector<Type>& types, json& out) const {
+  out = json::array();
+  size_t pos = 0;
+  for (const Type& type : types) {
+    json value;
+    if (!this->decode(type, pos, value)) return false;
+    out.push_back(std::move(value));
+    pos += type.headSize();
+  }
+  return true;
+}
+
+bool ABI::decodeRevert(dev::bytesConstRef data, const std::vector<Function>& errors, json& out) {
+  static const std::vector<Function> builtin = []{
+    std::vector<Function> ret(2);
+    Function::fromJson({{"name", "Error"}, {"inputs", json::array({{{"type", "string"}}})}}, ret[0]);
+    Function::fromJson({{"name", "Panic"}, {"inputs", json::array({{{"type", "uint256"}}})}}, ret[1]);
+    return ret;
+  }();
+  out = json();
+  if (data.size() < 4) return false;
+  dev::bytesConstRef sel = data.cropped(0, 4);
+  for (const std::vector<Function>* list : { &builtin, &errors }) {
+    for (const Function& f : *list) {
+      if (f.selector.size() != 4) continue;
+      if (!std::equal(f.selector.begin(), f.selector.end(), sel.begin())) continue;
+      out = {{"name", f.name}, {"signature", f.signature}};
+      json args;
+      if (!Decoder(data.cropped(4)).decode(f.inputs, args)) return false;
+      out["args"] = std::move(args);
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ABI::Event::fromJson(const json& entry, Event& out) {
+  out = Event();
+  if (!entry.is_object() || !entry.contains("name") || !optional(entry, "name", out.name)) return false;
+  if (!optional(entry, "anonymous", out.anonymous)) return false;
+  json inputs = entry.value("inputs", json::array());
+  if (!inputs.is_array()) return false;
+  out.topicCount = (out.anonymous) ? 0 : 1;
+  out.signature = out.name + "(";
+  for (const json& param : inputs) {
+    Type t;
+    bool indexed = false;
+    std::string name;
+    if (!Type::fromJson(param, t)) return false;
+    if (!optional(param, "indexed", indexed) || !optional(param, "name", name)) return false;
+    out.signature += t.canonical() + ",";
+    if (indexed) out.topicCount++; else out.dataTypes.push_back(t);
+    out.inputs.push_back(std::move(t));
+    out.names.push_back(std::move(name));
+    out.indexed.push_back(indexed);
+  }
+  if (out.topicCount > 4) return false;  // LOG4 is the most there is
+  if (out.signature.back() == ',') out.signature.pop_back();
+  out.signature += ")";
+  out.topic = dev::sha3(out.signature);
+  return true;
+}
+
+bool ABI::Event::decode(
+  const std::vector<dev::h256>& topics, dev::bytesConstRef data, json& out
+) const {
+  if (topics.size() != this->topicCount) return false;
+  if (!this->anonymous && topics[0] != this->topic) return false;
+  json values;
+  if (!Decoder(data).decode(this->dataTypes, values)) return false;
+  json args = json::array();
+  size_t topic = (this->anonymous) ? 0 : 1;
+  size_t value = 0;
+  for (size_t i = 0; i < this->inputs.size(); i++) {
+    if (!this->indexed[i]) { args.push_back(std::move(values[value++])); continue; }
+    const Type& t = this->inputs[i];
+    const dev::h256& word = topics[topic++];
+    // Only the hash of the encoding is kept for anything that isn't a single word
+    if (t.kind == Type::Bytes || t.kind == Type::String ||
+      t.kind == Type::Array || t.kind == Type::Tuple
+    ) {
+      args.push_back("0x" + word.hex());
+      continue;
+    }
+    json item;
+    if (!Decoder(word.ref()).decode(t, 0, item)) return false;
+    args.push_back(std::move(item));
+  }
+  out = {{"name", this->name}, {"signature", this->signature}, {"args", std::move(args)}};
+  return true;
+}
+
+bool ABI::EventRegistry::add(const Event& event) {
+  if (event.anonymous) return false;
+  std::vector<Event>& list = this->events[event.topic];
+  for (const Event& e : list) if (e.indexed == event.indexed) return false;
+  list.push_back(event);
+  return true;
+}
+
+size_t ABI::EventRegistry::add(const json& abi) {
+  size_t ret = 0;
+  if (!abi.is_array()) return ret;
+  for (const json& entry : abi) {
+    if (!entry.is_object() || entry.value("type", json()) != "event") continue;
+    Event event;
+    if (Event::fromJson(entry, event) && this->add(event)) ret++;
+  }
+  return ret;
+}
+
+size_t ABI::EventRegistry::size() const {
+  size_t ret = 0;
+  for (const auto& item : this->events) ret += item.second.size();
+  return ret;
+}
+
+const ABI::Event* ABI::EventRegistry::find(const std::vector<dev::h256>& topics) const {
+  if (topics.empty()) return nullptr;
+  auto it = this->events.find(topics[0]);
+  if (it == this->events.end()) return nullptr;
+  for (const Event& event : it->second) {
+    if (event.topicCount == topics.size()) return &event;
+  }
+  return nullptr;
+}
+
+bool ABI::EventRegistry::decode(
+  const std::vector<dev::h256>& topics, dev::bytesConstRef data, json& out
+) const {
+  const Event* event = this->find(topics);
+  return (event != nullptr && event->decode(topics, data, out));
+}
+
+bool ABI::EventRegistry::decode(const json& log, json& out) const {
+  if (!log.is_object() || !log.contains("topics") || !log["topics"].is_array()) return false;
+  // Reused across calls, as logs are usually decoded in bulk
+  thread_local std::vector<dev::h256> topics;
+  thread_local dev::bytes data;
+  topics.clear();
+  for (const json& topic : log["topics"]) {
+    if (!topic.is_string()) return false;
+    const std::string& hex = topic.get_ref<const std::string&>();
+    if (hex.size() != 66 || !Utils::isHexStrict(hex)) return false;
+    putHex(std::string_view(hex).substr(2), topics.emplace_back().data());
+  }
+  if (!log.contains("data") || !log["data"].is_string()) return false;
+  const std::string& hex = log["data"].get_ref<const std::string&>();
+  if (!Utils::isHexStrict(hex) || hex.size() % 2 != 0) return false;
+  data.resize((hex.size() - 2) / 2);
+  putHex(std::string_view(hex).substr(2), data.data());
+  return this->decode(topics, &data, out);
+}
@@ -1,19 +1,17 @@
 #include <web3cpp/Account.h>
 
 Account::Account(
-  const boost::filesystem::path& walletPath, const std::string& __address, const std::string& __name,
+  const Database& historyDB, const std::string& __address, const std::string& __name,
   const std::string& __derivationPath, bool __isLedger, const std::unique_ptr<Provider>& _provider
 ) : _address(__address), _name(__name), _derivationPath(__derivationPath),
   _isLedger(__isLedger), provider(_provider),
-  transactionDB("transactions/" + __address, walletPath)
-{
-  Error error;
-  std::string nonceRequest = Net::HTTPRequest(
-    this->provider, Net::RequestTypes::POST,
-    RPC::eth_getTransactionCount(_address, "latest", error).dump()
-  );
-  json nonceJson = json::parse(nonceRequest);
-  _nonce = boost::lexical_cast<HexTo<uint64_t>>(nonceJson["result"].get<std::string>());
+  transactionDB(historyDB),
+  _txIndex(transactionDB, dev::Address(__address)),
+  _nonceManager(std::make_shared<NonceManager>(__address, _provider, transactionDB))
+{}
+
+uint64_t Account::nonce() const {
+  return this->_nonceManager->peek();
 }
 
 std::future<BigNumber> Account::balance() const {
@@ -36,19 +34,106 @@ std::future<BigNumber> Account::balance() const {
 }
 
 bool Account::saveTxToHistory(std::string signedTx) {
-  json txData = Utils::decodeRawTransaction(signedTx);
-  return this->transactionDB.putKeyValue(txData["hash"], txData.dump());
+  std::shared_ptr<HistoryWriter> writer = std::atomic_load(&this->historyWriter);
+  if (writer) return writer->enqueue(this->_txIndex, std::move(signedTx));
+  return this->_txIndex.save(TxRecord::fromSignedTx(signedTx));
+}
+
+bool Account::saveTxsToHistory(const std::vector<std::string>& signedTxs) {
+  std::shared_ptr<HistoryWriter> writer = std::atomic_load(&this->historyWriter);
+  if (writer) {
+    for (const std::string& signedTx : signedTxs) {
+      if (!writer->enqueue(this->_txIndex, signedTx)) return false;
+    }
+    return true;
+  }
+  Database::Batch batch = this->transactionDB.batch();
+  for (const std::string& signedTx : signedTxs) {
+    this->_txIndex.add(batch, TxRecord::fromSignedTx(signedTx));
+  }
+  return batch.commit();
+}
+
+namespace {
+  /**
+   * Visit the history entries in key order, after a given key.
+   * Internal keys (e.g. the nonce state and the indexes) all start with "_",
+   * so the cursors are bounded around them instead of walking over them.
+   * @param &db The account's transaction database.
+   * @param &after Only visit keys after this one. Empty means from the start.
+   * @param visit Called with each cursor entry. Returns `false` to stop.
+   */
+  template <typename Visit>
+  void forEachEntry(const Database& db, const std::string& after, Visit visit) {
+    // The smallest key that sorts after the previous page's last one
+    std::string start = (after.empty()) ? "" : after + std::string(1, '\0');
+    Database::Range before;
+    before.start = start;
+    before.end = "_";
+    for (Database::Cursor c = db.cursor(before); c.valid(); c.next()) {
+      if (!visit(c)) return;
+    }
+    // Anything sorting after the internal keys, which is "`" onwards
+    Database::Range past;
+    past.start = (start > "`") ? start : "`";
+    for (Database::Cursor c = db.cursor(past); c.valid(); c.next()) {
+      if (!visit(c)) return;
+    }
+  }
+
+  /// Get the JSON string for a stored record. Legacy JSON records are returned as they are.
+  std::string historyEntry(std::string_view stored) {
+    TxRecord record;
+    if (TxRecord::isLegacy(stored) || !TxRecord::fromStored(stored, record)) {
+      return std::string(stored);
+    }
+    return record.toJson().dump();
+  }
 }
 
 json Account::getTxHistory() const {
   json ret;
-  std::map<std::string, std::string> hist = this->transactionDB.getAllPairs();
-  for (std::pair<std::string, std::string> item : hist) {
-    ret[item.first] = item.second;
-  }
+  forEachEntry(this->transactionDB, "", [&ret](const Database::Cursor& c){
+    ret[std::string(c.key())] = historyEntry(c.value());
+    return true;
+  });
   return ret;
 }
 
+json Account::getTxHistory(uint64_t limit, const std::string& after) const {
+  json ret = json::object();
+  if (limit == 0) return ret;
+  forEachEntry(this->transactionDB, after, [&ret, limit](const Database::Cursor& c){
+    ret[std::string(c.key())] = historyEntry(c.value());
+    return ret.size() < limit;
+  });
+  return ret;
+}
 
+std::vector<TxRecord> Account::getTxRecords(uint64_t limit, const std::string& after) const {
+  std::vector<TxRecord> ret;
+  if (limit == 0) return ret;
+  TxRecord record;
+  forEachEntry(this->transactionDB, after, [&ret, &record, limit](const Database::Cursor& c){
+    if (TxRecord::fromStored(c.value(), record)) ret.push_back(std::move(record));
+    return ret.size() < limit;
+  });
+  return ret;
+}
 
+bool Account::markTxConfirmed(const std::string& hash, uint64_t blockNumber) {
+  TxRecord record;
+  if (!this->_txIndex.get(hash, record)) return false;
+  record.confirmed = true;
+  record.invalid = false;
+  record.blockNumber = blockNumber;
+  return this->_txIndex.save(record);
+}
 
+bool Account::markTxInvalid(const std::string& hash) {
+  TxRecord record;
+  if (!this->_txIndex.get(hash, record)) return false;
+  record.confirmed = false;
+  record.invalid = true;
+  return this->_txIndex.save(record);
+}
@@ -0,0 +1,74 @@
+#include <web3cpp/BlockWatcher.h>
+
+BlockWatcher::BlockWatcher(
+  const std::unique_ptr<Provider>& _provider, unsigned int _pollIntervalMs
+) : provider(_provider), pollIntervalMs(_pollIntervalMs) {
+  this->pollThread = std::thread(&BlockWatcher::pollLoop, this);
+}
+
+BlockWatcher::~BlockWatcher() {
+  {
+    std::lock_guard<std::mutex> lock(this->stopLock);
+    this->stopping = true;
+  }
+  this->stopCv.notify_all();
+  if (this->pollThread.joinable()) this->pollThread.join();
+}
+
+uint64_t BlockWatcher::fetchHead() {
+  try {
+    json res = json::parse(Net::HTTPRequest(
+      this->provider, Net::RequestTypes::POST, RPC::eth_blockNumber().dump()
+    ));
+    if (res.contains("result") && res["result"].is_string()) {
+      return boost::lexical_cast<HexTo<uint64_t>>(res["result"].get<std::string>());
+    }
+  } catch (std::exception &e) {
+  } catch (std::string &e) {}
+  return 0;
+}
+
+void BlockWatcher::pollLoop() {
+  while (true) {
+    uint64_t newHead = this->fetchHead();
+    if (newHead != 0) this->notify(newHead);
+    std::unique_lock<std::mutex> lock(this->stopLock);
+    if (this->stopCv.wait_for(lock, std::chrono::milliseconds(this->pollIntervalMs),
+      [this]{ return this->stopping; })) break;
+  }
+}
+
+void BlockWatcher::notify(uint64_t newHead) {
+  // Copy the callbacks so they can (un)subscribe from inside themselves
+  std::vector<std::pair<uint64_t, Callback>> callbacks;
+  std::lock_guard<std::recursive_mutex> dispatch(this->dispatchLock);
+  if (newHead <= this->_head) return;
+  this->_head = newHead;
+  {
+    std::lock_guard<std::mutex> lock(this->subLock);
+    callbacks.assign(this->subscribers.begin(), this->subscribers.end());
+  }
+  for (std::pair<uint64_t, Callback>& cb : callbacks) {
+    {
+      std::lock_guard<std::mutex> lock(this->subLock);
+      if (!this->subscribers.count(cb.first)) continue;
+    }
+    cb.second(newHead);
+  }
+}
+
+uint64_t BlockWatcher::subscribe(Callback cb) {
+  std::lock_guard<std::mutex> lock(this->subLock);
+  uint64_t id = this->nextSubId++;
+  this->subscribers.emplace(id, std::move(cb));
+  return id;
+}
+
+void BlockWatcher::unsubscribe(uint64_t id) {
+  {
+    std::lock_guard<std::mutex> lock(this->subLock);
+    this->subscribers.erase(id);
+  }
+  // Wait for any running callback to finish
+  std::lock_guard<std::recursive_mutex> dispatch(this->dispatchLock);
+}
@@ -0,0 +1,189 @@
+#include <web3cpp/ConfirmationTracker.h>
+
+namespace {
+  // Read the block number of a receipt, which must be a valid quantity
+  bool readBlockNumber(const json& receipt, uint64_t& out) {
+    if (!receipt.is_object() || !receipt.contains("blockNumber")) return false;
+    const json& num = receipt["blockNumber"];
+    if (!num.is_string()) return false;
+    const std::string& str = num.get_ref<const std::string&>();
+    if (str.size() <= 2 || str.size() > 18 || !Utils::isHexStrict(str)) return false;
+    out = boost::lexical_cast<HexTo<uint64_t>>(str);
+    return true;
+  }
+}
+
+ConfirmationTracker::ConfirmationTracker(
+  BlockWatcher& _watcher, unsigned int _defaultConfirmations,
+  unsigned int _timeoutSec, unsigned int _batchSize
+) : watcher(_watcher), eth(_watcher.getProvider()),
+  defaultConfirmations((_defaultConfirmations > 0) ? _defaultConfirmations : 1),
+  timeoutSec(_timeoutSec), batchSize((_batchSize > 0) ? _batchSize : 1)
+{
+  this->worker = std::thread(&ConfirmationTracker::workLoop, this);
+  this->subId = this->watcher.subscribe([this](uint64_t head){ this->onHead(head); });
+}
+
+ConfirmationTracker::ConfirmationTracker(BlockWatcher& _watcher, const Contract::Options& opts)
+  : ConfirmationTracker(_watcher, opts.transactionConfirmationBlocks, opts.transactionPollingTimeout)
+{}
+
+ConfirmationTracker::~ConfirmationTracker() {
+  this->watcher.unsubscribe(this->subId);
+  {
+    std::lock_guard<std::mutex> lock(this->watchLock);
+    this->stopping = true;
+  }
+  this->workCv.notify_all();
+  if (this->worker.joinable()) this->worker.join();
+  std::map<uint64_t, std::shared_ptr<Watch>> remaining;
+  {
+    std::lock_guard<std::mutex> lock(this->watchLock);
+    remaining.swap(this->watches);
+  }
+  for (std::pair<const uint64_t, std::shared_ptr<Watch>>& w : remaining) {
+    TimerService::instance().cancel(w.second->timer);
+    this->resolve(*w.second, 37); // Transaction Receipt Timeout
+  }
+}
+
+void ConfirmationTracker::onHead(uint64_t head) {
+  {
+    std::lock_guard<std::mutex> lock(this->watchLock);
+    if (head <= this->newHead) return;
+    this->newHead = head;
+  }
+  this->workCv.notify_one();
+}
+
+void ConfirmationTracker::workLoop() {
+  while (true) {
+    uint64_t head;
+    std::vector<uint64_t> timedOut;
+    {
+      std::unique_lock<std::mutex> lock(this->watchLock);
+      this->workCv.wait(lock, [this]{
+        return this->stopping || this->newHead != 0 || !this->expired.empty();
+      });
+      if (this->stopping) break;
+      head = this->newHead;
+      this->newHead = 0;
+      timedOut.swap(this->expired);
+    }
+    if (!timedOut.empty()) this->expire(timedOut);
+    if (head != 0) this->check(head);
+  }
+}
+
+void ConfirmationTracker::check(uint64_t head) {
+  std::vector<std::pair<uint64_t, std::shared_ptr<Watch>>> current;
+  {
+    std::lock_guard<std::mutex> lock(this->watchLock);
+    current.assign(this->watches.begin(), this->watches.end());
+  }
+  if (current.empty()) return;
+
+  // Receipts are refetched even after being found, since a receipt that
+  // changes blocks or disappears is how a reorg shows up over HTTP
+  json requests = json::array();
+  for (std::pair<uint64_t, std::shared_ptr<Watch>>& w : current) {
+    Error rpcErr;
+    requests.push_back(RPC::eth_getTransactionReceipt(w.second->status.hash, rpcErr));
+  }
+  json responses = this->eth.batchRequest(requests, this->batchSize).get();
+
+  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+  std::vector<std::pair<uint64_t, uint64_t>> done;  // Watch id and error code
+  for (uint64_t i = 0; i < current.size(); i++) {
+    Watch& w = *current[i].second;
+    const json& res = responses[i];
+    if (!res.contains("error") && res.contains("result")) {
+      const json& receipt = res["result"];
+      bool hadReceipt = !w.status.receipt.is_null();
+      uint64_t mined;
+      if (readBlockNumber(receipt, mined)) {
+        if (hadReceipt && w.status.receipt["blockHash"] != receipt["blockHash"]) w.status.reorgs++;
+        w.status.receipt = receipt;
+        w.mined = mined;
+      } else if (hadReceipt) {
+        w.status.reorgs++;
+        w.status.receipt = json();
+      }
+    }
+
+    if (!w.status.receipt.is_null()) {
+      w.status.confirmations = (head >= w.mined) ? head - w.mined + 1 : 0;
+      if (w.status.confirmations >= w.required) {
+        bool reverted = (w.status.receipt.contains("status") && w.status.receipt["status"] == "0x0");
+        done.emplace_back(current[i].first, (reverted) ? 38 : 0); // Transaction Reverted
+      }
+    } else {
+      w.status.confirmations = 0;
+      if (now > w.deadline) done.emplace_back(current[i].first, 37); // Transaction Receipt Timeout
+    }
+  }
+  for (std::pair<uint64_t, uint64_t>& d : done) this->finish(d.first, d.second);
+}
+
+void ConfirmationTracker::expire(const std::vector<uint64_t>& ids) {
+  for (uint64_t id : ids) {
+    std::shared_ptr<Watch> w;
+    {
+      std::lock_guard<std::mutex> lock(this->watchLock);
+      auto it = this->watches.find(id);
+      if (it == this->watches.end()) continue;
+      w = it->second;
+    }
+    // Mined transactions keep waiting for their confirmations. If their
+    // receipt disappears later on, the deadline is checked on the next head.
+    if (w->status.receipt.is_null()) this->finish(id, 37); // Transaction Receipt Timeout
+  }
+}
+
+void ConfirmationTracker::finish(uint64_t id, uint64_t errorCode) {
+  std::shared_ptr<Watch> w;
+  {
+    std::lock_guard<std::mutex> lock(this->watchLock);
+    auto it = this->watches.find(id);
+    if (it == this->watches.end()) return;
+    w = it->second;
+    this->watches.erase(it);
+  }
+  TimerService::instance().cancel(w->timer);
+  this->resolve(*w, errorCode);
+}
+
+void ConfirmationTracker::resolve(Watch& w, uint64_t errorCode) {
+  w.status.errorCode = errorCode;
+  if (w.cb) w.cb(w.status);
+  w.promise.set_value(w.status);
+}
+
+std::future<ConfirmationTracker::Status> ConfirmationTracker::watch(
+  const std::string& hash, Callback cb, unsigned int confirmations
+) {
+  std::shared_ptr<Watch> w = std::make_shared<Watch>();
+  w->status.hash = hash;
+  w->required = (confirmations > 0) ? confirmations : this->defaultConfirmations;
+  w->deadline = std::chrono::steady_clock::now() + std::chrono::seconds(this->timeoutSec);
+  w->cb = std::move(cb);
+  std::future<Status> ret = w->promise.get_future();
+  std::lock_guard<std::mutex> lock(this->watchLock);
+  uint64_t id = this->nextWatchId++;
+  // The timer only hands the watch over to the worker thread, which
+  // resolves it unless a receipt was found in the meantime
+  w->timer = TimerService::instance().schedule(std::chrono::seconds(this->timeoutSec), [this, id]{
+    {
+      std::lock_guard<std::mutex> lock(this->watchLock);
+      this->expired.push_back(id);
+    }
+    this->workCv.notify_one();
+  });
+  this->watches.emplace(id, std::move(w));
+  return ret;
+}
+
+std::size_t ConfirmationTracker::pending() const {
+  std::lock_guard<std::mutex> lock(this->watchLock);
+  return this->watches.size();
+}
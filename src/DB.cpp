@@ -1,127 +1,210 @@
 #include <web3cpp/DB.h>
 
 bool Database::openDB() {
-  this->dbMutex.lock();
-  if (!boost::filesystem::exists(this->path)) {
-    boost::filesystem::create_directories(this->path);
-  }
-  this->dbStatus = leveldb::DB::Open(this->dbOpts, this->path.string(), &this->db);
-  if (!this->dbStatus.ok()) {
-    this->dbMutex.unlock();
+  std::string error;
+  this->db = LevelDBBackend::open(this->path, this->options, error);
+  if (this->db == nullptr) {
     std::cout << "Error opening " << this->name << " database!"
-      << this->dbStatus.ToString() << std::endl;
+      << error << std::endl;
     return false;
   }
-  this->dbMutex.unlock();
   return true;
 }
 
 bool Database::closeDB() {
-  this->dbMutex.lock();
-  if (this->db == nullptr) {
-    return true;
-  }
-  delete this->db;
-  this->db = nullptr;
-  this->dbMutex.unlock();
+  this->snap.reset();
+  this->db.reset();
   return true;
 }
 
-bool Database::keyExists(std::string const &key) const {
-  this->dbMutex.lock();
-  leveldb::Iterator* it = this->db->NewIterator(leveldb::ReadOptions());
-  for (it->SeekToFirst(); it->Valid(); it->Next()) {
-    if (it->key().ToString() == key) {
-      delete it;
-      this->dbMutex.unlock();
-      return true;
-    }
+Database Database::inMemory(const std::string& _name) {
+  return Database(std::make_shared<MemoryBackend>(), _name);
+}
+
+Database Database::openTable(const boost::filesystem::path& file) {
+  std::string error;
+  std::shared_ptr<TableBackend> table = TableBackend::open(file, error);
+  if (table == nullptr) {
+    std::cout << "Error opening table " << file.string() << ": " << error << std::endl;
   }
-  delete it;
-  this->dbMutex.unlock();
-  return false;
+  Database ret(table, file.filename().string());
+  ret.path = file;
+  return ret;
 }
 
-std::string Database::getKeyValue(std::string const &key) {
-  this->dbMutex.lock();
-  this->dbStatus = this->db->Get(leveldb::ReadOptions(), key, &this->tmpValue);
-  if (!this->dbStatus.ok()) {
-    this->dbMutex.unlock();
-    return "";
+bool Database::exportTable(const boost::filesystem::path& file) const {
+  TableBackend::Writer writer(file);
+  for (Cursor c = this->cursor(); c.valid(); c.next()) {
+    if (!writer.add(c.key(), c.value())) return false;
   }
-  this->dbMutex.unlock();
-  return this->tmpValue;
+  return writer.finish();
 }
 
-bool Database::putKeyValue(std::string const &key, std::string const &value) {
-  this->dbMutex.lock();
-  this->dbStatus = this->db->Put(leveldb::WriteOptions(), key, value);
-  if (!this->dbStatus.ok()) {
-    this->dbMutex.unlock();
-    std::cout << "Error putting key " << key << " at database " << this->name
-      << ": " << this->dbStatus.ToString();
+Database Database::partition(const std::string& _prefix) const {
+  Database ret(*this);
+  ret.name = this->name + ":" + _prefix;
+  ret.prefix = this->prefix + _prefix;
+  return ret;
+}
+
+Database Database::snapshot() const {
+  Database ret(*this);
+  ret.snap = this->db->snapshot();
+  return ret;
+}
+
+bool Database::write(const std::vector<DBBackend::Write>& writes, bool sync) {
+  std::string error;
+  if (!this->db->write(writes, sync, error)) {
+    std::cout << "Error writing " << writes.size() << " keys at database "
+      << this->name << ": " << error << std::endl;
     return false;
   }
-  this->dbMutex.unlock();
-  return this->dbStatus.ok();
+  return true;
+}
+
+bool Database::keyExists(std::string const &key) const {
+  std::string value;
+  return this->getKeyValue(key, value);
+}
+
+std::string Database::getKeyValue(std::string const &key) const {
+  std::string value;
+  this->getKeyValue(key, value);
+  return value;
+}
+
+bool Database::getKeyValue(std::string const &key, std::string &value) const {
+  return this->db->get(this->fullKey(key), value, this->snap.get());
+}
+
+bool Database::putKeyValue(std::string const &key, std::string const &value) {
+  return this->write({{false, this->fullKey(key), value}}, false);
 }
 
 bool Database::deleteKeyValue(std::string const &key) {
-  this->dbMutex.lock();
-  this->dbStatus = this->db->Delete(leveldb::WriteOptions(), key);
-  if(!this->dbStatus.ok()) {
-    this->dbMutex.unlock();
-    std::cout << "Error deleting key " << key << " at database " << this->name
-      << ": " << this->dbStatus.ToString();
-    return false;
-  }
-  this->dbMutex.unlock();
-  return this->dbStatus.ok();
+  return this->write({{true, this->fullKey(key), ""}}, false);
+}
+
+Database::Cursor Database::cursor() const {
+  return Cursor(*this, Range());
+}
+
+Database::Cursor Database::cursor(const Range& range) const {
+  return Cursor(*this, range);
 }
 
 std::vector<std::string> Database::getAllKeys() const {
-  this->dbMutex.lock();
   std::vector<std::string> ret;
-  leveldb::Iterator* it = this->db->NewIterator(leveldb::ReadOptions());
-  for (it->SeekToFirst(); it->Valid(); it->Next()) {
-    ret.push_back(it->key().ToString());
-  }
-  delete it;
-  this->dbMutex.unlock();
+  for (Cursor c = this->cursor(); c.valid(); c.next()) ret.emplace_back(c.key());
   return ret;
 }
 
 std::vector<std::string> Database::getAllValues() const {
-  this->dbMutex.lock();
   std::vector<std::string> ret;
-  leveldb::Iterator* it = this->db->NewIterator(leveldb::ReadOptions());
-  for (it->SeekToFirst(); it->Valid(); it->Next()) {
-    ret.push_back(it->value().ToString());
-  }
-  delete it;
-  this->dbMutex.unlock();
+  for (Cursor c = this->cursor(); c.valid(); c.next()) ret.emplace_back(c.value());
   return ret;
 }
 
 std::map<std::string, std::string> Database::getAllPairs() const {
-  this->dbMutex.lock();
   std::map<std::string, std::string> ret;
-  leveldb::Iterator* it = this->db->NewIterator(leveldb::ReadOptions());
-  for (it->SeekToFirst(); it->Valid(); it->Next()) {
-    ret.emplace(it->key().ToString(), it->value().ToString());
-  }
-  delete it;
-  this->dbMutex.unlock();
+  for (Cursor c = this->cursor(); c.valid(); c.next()) ret.emplace(c.key(), c.value());
   return ret;
 }
 
-void Database::dropDatabase() {
-  this->dbMutex.lock();
-  leveldb::Iterator* it = this->db->NewIterator(leveldb::ReadOptions());
-  for (it->SeekToFirst(); it->Valid(); it->Next()) {
-    this->db->Delete(leveldb::WriteOptions(), it->key().ToString());
+Database::Batch Database::batch() const {
+  return Batch(*this);
+}
+
+bool Database::dropDatabase() {
+  Batch drop = this->batch();
+  for (Cursor c = this->cursor(); c.valid(); c.next()) drop.del(std::string(c.key()));
+  return drop.commit();
+}
+
+void Database::Batch::put(const std::string& key, const std::string& value) {
+  this->writes.push_back({false, this->owner.fullKey(key), value});
+}
+
+bool Database::Batch::put(const Database& part, const std::string& key, const std::string& value) {
+  if (part.db != this->owner.db) return false;
+  this->writes.push_back({false, part.fullKey(key), value});
+  return true;
+}
+
+void Database::Batch::del(const std::string& key) {
+  this->writes.push_back({true, this->owner.fullKey(key), ""});
+}
+
+bool Database::Batch::del(const Database& part, const std::string& key) {
+  if (part.db != this->owner.db) return false;
+  this->writes.push_back({true, part.fullKey(key), ""});
+  return true;
+}
+
+bool Database::Batch::commit(bool sync) {
+  if (this->writes.empty() && !sync) return true;
+  if (!this->owner.write(this->writes, sync)) return false;
+  this->rollback();
+  return true;
+}
+
+namespace {
+  /**
+   * Get the first key after every key that starts with a given prefix.
+   * @param prefix The prefix.
+   * @return The bound, or an empty string if there's none (empty or all-0xff prefix).
+   */
+  std::string prefixEnd(std::string prefix) {
+    while (!prefix.empty() && static_cast<unsigned char>(prefix.back()) == 0xff) prefix.pop_back();
+    if (!prefix.empty()) prefix.back() = static_cast<char>(static_cast<unsigned char>(prefix.back()) + 1);
+    return prefix;
+  }
+}
+
+Database::Cursor::Cursor(const Database& _db, const Range& range)
+  : db(_db.db), snap(_db.snap), stripSize(_db.prefix.size()),
+  reverse(range.reverse), remaining(range.limit), limited(range.limit > 0)
+{
+  std::string scan = _db.prefix + range.prefix;
+  this->lower = std::max(scan, _db.prefix + range.start);
+  this->upper = prefixEnd(scan);
+  if (!range.end.empty()) {
+    std::string end = _db.prefix + range.end;
+    if (this->upper.empty() || end < this->upper) this->upper = end;
   }
-  this->dbMutex.unlock();
-  delete it;
+  this->it = this->db->iterator(this->snap.get());
+  if (!this->reverse) {
+    this->it->seek(this->lower);
+  } else if (this->upper.empty()) {
+    this->it->seekToLast();
+  } else {
+    // Land on the first key past the range, then step back into it
+    this->it->seek(this->upper);
+    if (this->it->valid()) this->it->prev(); else this->it->seekToLast();
+  }
+}
+
+bool Database::Cursor::inRange() const {
+  std::string_view k = this->it->key();
+  if (k < this->lower) return false;
+  return (this->upper.empty() || k < this->upper);
+}
+
+bool Database::Cursor::valid() const {
+  if (this->limited && this->remaining == 0) return false;
+  return (this->it->valid() && this->inRange());
+}
+
+void Database::Cursor::next() {
+  if (this->reverse) this->it->prev(); else this->it->next();
+  if (this->limited && this->remaining > 0) this->remaining--;
+}
+
+std::string_view Database::Cursor::key() const {
+  return this->it->key().substr(this->stripSize);
 }
 
+std::string_view Database::Cursor::value() const {
+  return this->it->value();
+}
@@ -0,0 +1,335 @@
+#include <web3cpp/DBBackend.h>
+
+DatabaseOptions DatabaseOptions::readHeavy() {
+  DatabaseOptions ret;
+  ret.cacheSize = 64 << 20;
+  ret.maxOpenFiles = 4096;
+  return ret;
+}
+
+DatabaseOptions DatabaseOptions::writeHeavy() {
+  DatabaseOptions ret;
+  ret.writeBufferSize = 64 << 20;
+  return ret;
+}
+
+std::shared_ptr<leveldb::Cache> DatabaseOptions::sharedCache(size_t capacity) {
+  return std::shared_ptr<leveldb::Cache>(leveldb::NewLRUCache(capacity));
+}
+
+class LevelDBBackend::LevelDBSnapshot : public DBBackend::Snapshot {
+  public:
+    std::shared_ptr<const LevelDBBackend> owner;  ///< Keeps the database open while the snapshot lives.
+    const leveldb::Snapshot* snap;                ///< The LevelDB snapshot.
+    LevelDBSnapshot(std::shared_ptr<const LevelDBBackend> _owner, const leveldb::Snapshot* _snap)
+      : owner(std::move(_owner)), snap(_snap) {}
+    ~LevelDBSnapshot() { owner->db->ReleaseSnapshot(snap); }
+};
+
+class LevelDBBackend::LevelDBIterator : public DBBackend::Iterator {
+  private:
+    std::unique_ptr<leveldb::Iterator> it;  ///< The LevelDB iterator.
+
+  public:
+    LevelDBIterator(leveldb::Iterator* _it) : it(_it) {}
+    bool valid() const override { return it->Valid(); }
+    void seekToFirst() override { it->SeekToFirst(); }
+    void seekToLast() override { it->SeekToLast(); }
+    void seek(std::string_view key) override { it->Seek(leveldb::Slice(key.data(), key.size())); }
+    void next() override { it->Next(); }
+    void prev() override { it->Prev(); }
+    std::string_view key() const override {
+      leveldb::Slice k = it->key(); return std::string_view(k.data(), k.size());
+    }
+    std::string_view value() const override {
+      leveldb::Slice v = it->value(); return std::string_view(v.data(), v.size());
+    }
+};
+
+std::shared_ptr<LevelDBBackend> LevelDBBackend::open(
+  const boost::filesystem::path& path, const DatabaseOptions& options, std::string& error
+) {
+  if (!boost::filesystem::exists(path)) {
+    boost::filesystem::create_directories(path);
+  }
+  std::shared_ptr<LevelDBBackend> ret = std::make_shared<LevelDBBackend>();
+  ret->cache = (options.cache) ? options.cache : DatabaseOptions::sharedCache(options.cacheSize);
+  // Point lookups for missing keys (e.g. keyExists()) skip the disk
+  if (options.bloomBitsPerKey > 0) {
+    ret->filter.reset(leveldb::NewBloomFilterPolicy(options.bloomBitsPerKey));
+  }
+  leveldb::Options dbOpts;
+  dbOpts.create_if_missing = true;
+  dbOpts.block_cache = ret->cache.get();
+  dbOpts.filter_policy = ret->filter.get();
+  dbOpts.compression = (options.compression)
+    ? leveldb::kSnappyCompression : leveldb::kNoCompression;
+  dbOpts.write_buffer_size = options.writeBufferSize;
+  dbOpts.max_open_files = options.maxOpenFiles;
+  dbOpts.paranoid_checks = options.paranoidChecks;
+
+  leveldb::DB* handle = nullptr;
+  leveldb::Status status = leveldb::DB::Open(dbOpts, path.string(), &handle);
+  if (!status.ok()) {
+    error = status.ToString();
+    return nullptr;
+  }
+  ret->db.reset(handle);
+  return ret;
+}
+
+bool LevelDBBackend::get(const std::string& key, std::string& value, const Snapshot* snap) const {
+  leveldb::ReadOptions opts;
+  if (snap != nullptr) opts.snapshot = static_cast<const LevelDBSnapshot*>(snap)->snap;
+  return this->db->Get(opts, key, &value).ok();
+}
+
+bool LevelDBBackend::write(const std::vector<Write>& writes, bool sync, std::string& error) {
+  leveldb::WriteOptions opts;
+  opts.sync = sync;
+  leveldb::Status status;
+  if (writes.size() == 1) {
+    // Single writes skip building a batch
+    status = (writes[0].erase)
+      ? this->db->Delete(opts, writes[0].key)
+      : this->db->Put(opts, writes[0].key, writes[0].value);
+  } else {
+    leveldb::WriteBatch batch;
+    for (const Write& w : writes) {
+      if (w.erase) batch.Delete(w.key); else batch.Put(w.key, w.value);
+    }
+    status = this->db->Write(opts, &batch);
+  }
+  if (!status.ok()) { error = status.ToString(); return false; }
+  return true;
+}
+
+std::unique_ptr<DBBackend::Iterator> LevelDBBackend::iterator(const Snapshot* snap) const {
+  leveldb::ReadOptions opts;
+  if (snap != nullptr) opts.snapshot = static_cast<const LevelDBSnapshot*>(snap)->snap;
+  return std::make_unique<LevelDBIterator>(this->db->NewIterator(opts));
+}
+
+std::shared_ptr<const DBBackend::Snapshot> LevelDBBackend::snapshot() const {
+  // The snapshot keeps a reference to the engine, so the engine must be
+  // owned by a shared_ptr (which open() guarantees)
+  std::shared_ptr<const LevelDBBackend> self(
+    std::static_pointer_cast<const LevelDBBackend>(this->shared_from_this())
+  );
+  return std::make_shared<LevelDBSnapshot>(self, this->db->GetSnapshot());
+}
+
+class MemoryBackend::MemorySnapshot : public DBBackend::Snapshot {
+  public:
+    std::shared_ptr<const Map> data;  ///< The data at the time of the snapshot.
+    MemorySnapshot(std::shared_ptr<const Map> _data) : data(std::move(_data)) {}
+};
+
+class MemoryBackend::MemoryIterator : public DBBackend::Iterator {
+  private:
+    std::shared_ptr<const Map> data;  ///< The data being iterated.
+    Map::const_iterator it;           ///< Current position. data->end() means invalid.
+
+  public:
+    MemoryIterator(std::shared_ptr<const Map> _data) : data(std::move(_data)), it(data->end()) {}
+    bool valid() const override { return it != data->end(); }
+    void seekToFirst() override { it = data->begin(); }
+    void seekToLast() override { it = (data->empty()) ? data->end() : std::prev(data->end()); }
+    void seek(std::string_view key) override { it = data->lower_bound(key); }
+    void next() override { ++it; }
+    void prev() override { it = (it == data->begin()) ? data->end() : std::prev(it); }
+    std::string_view key() const override { return it->first; }
+    std::string_view value() const override { return it->second; }
+};
+
+std::shared_ptr<const MemoryBackend::Map> MemoryBackend::current() const {
+  std::lock_guard<std::mutex> lock(this->dataLock);
+  return this->data;
+}
+
+bool MemoryBackend::get(const std::string& key, std::string& value, const Snapshot* snap) const {
+  if (snap != nullptr) {
+    const Map& m = *static_cast<const MemorySnapshot*>(snap)->data;
+    auto it = m.find(key);
+    if (it == m.end()) return false;
+    value = it->second;
+    return true;
+  }
+  std::lock_guard<std::mutex> lock(this->dataLock);
+  auto it = this->data->find(key);
+  if (it == this->data->end()) return false;
+  value = it->second;
+  return true;
+}
+
+bool MemoryBackend::write(const std::vector<Write>& writes, bool /*sync*/, std::string& /*error*/) {
+  std::lock_guard<std::mutex> lock(this->dataLock);
+  // Snapshots and iterators keep the old copy
+  if (this->data.use_count() > 1) this->data = std::make_shared<Map>(*this->data);
+  for (const Write& w : writes) {
+    if (w.erase) {
+      this->data->erase(w.key);
+    } else {
+      this->data->insert_or_assign(w.key, w.value);
+    }
+  }
+  return true;
+}
+
+std::unique_ptr<DBBackend::Iterator> MemoryBackend::iterator(const Snapshot* snap) const {
+  return std::make_unique<MemoryIterator>((snap != nullptr)
+    ? static_cast<const MemorySnapshot*>(snap)->data : this->current());
+}
+
+std::shared_ptr<const DBBackend::Snapshot> MemoryBackend::snapshot() const {
+  return std::make_shared<MemorySnapshot>(this->current());
+}
+
+namespace {
+  /// Read a little-endian integer of `n` bytes.
+  uint64_t readLE(const char* p, int n) {
+    uint64_t ret = 0;
+    for (int i = n - 1; i >= 0; i--) ret = (ret << 8) | static_cast<unsigned char>(p[i]);
+    return ret;
+  }
+
+  /// Append a little-endian integer of `n` bytes.
+  void writeLE(std::string& out, uint64_t v, int n) {
+    for (int i = 0; i < n; i++) { out.push_back(static_cast<char>(v & 0xff)); v >>= 8; }
+  }
+}
+
+const std::string TableBackend::magic = "W3CTABL1";
+
+class TableBackend::TableIterator : public DBBackend::Iterator {
+  private:
+    std::shared_ptr<const TableBackend> table;  ///< Keeps the file mapped while iterating.
+    uint64_t i;                                 ///< Current entry. table->count means invalid.
+    std::string_view k;                         ///< Current key.
+    std::string_view v;                         ///< Current value.
+
+    /// Decode the current entry, stopping on a corrupt one.
+    void load() { if (i < table->count && !table->entry(i, k, v)) i = table->count; }
+
+  public:
+    TableIterator(std::shared_ptr<const TableBackend> _table) : table(std::move(_table)), i(table->count) {}
+    bool valid() const override { return i < table->count; }
+    void seekToFirst() override { i = 0; load(); }
+    void seekToLast() override { i = (table->count > 0) ? table->count - 1 : 0; load(); }
+    void seek(std::string_view key) override { i = table->lowerBound(key); load(); }
+    void next() override { i++; load(); }
+    void prev() override { i = (i == 0) ? table->count : i - 1; load(); }
+    std::string_view key() const override { return k; }
+    std::string_view value() const override { return v; }
+};
+
+std::shared_ptr<TableBackend> TableBackend::open(const boost::filesystem::path& path, std::string& error) {
+  const uint64_t footerSize = 16 + magic.size();
+  if (!boost::filesystem::is_regular_file(path)) { error = "Table file not found"; return nullptr; }
+  if (boost::filesystem::file_size(path) < magic.size() + footerSize) {
+    error = "Table file too small"; return nullptr;
+  }
+  std::shared_ptr<TableBackend> ret = std::make_shared<TableBackend>();
+  try {
+    ret->file = boost::interprocess::file_mapping(path.string().c_str(), boost::interprocess::read_only);
+    ret->region = boost::interprocess::mapped_region(ret->file, boost::interprocess::read_only);
+  } catch (std::exception &e) {
+    error = e.what(); return nullptr;
+  }
+  ret->base = static_cast<const char*>(ret->region.get_address());
+  ret->size = ret->region.get_size();
+  const char* footer = ret->base + ret->size - footerSize;
+  if (std::string_view(ret->base, magic.size()) != magic
+    || std::string_view(footer + 16, magic.size()) != magic
+  ) {
+    error = "Not a table file"; return nullptr;
+  }
+  ret->indexOffset = readLE(footer, 8);
+  ret->count = readLE(footer + 8, 8);
+  if (ret->indexOffset < magic.size() || ret->indexOffset > ret->size - footerSize
+    || ret->count * 8 != ret->size - footerSize - ret->indexOffset
+  ) {
+    error = "Corrupt table index"; return nullptr;
+  }
+  return ret;
+}
+
+bool TableBackend::entry(uint64_t i, std::string_view& key, std::string_view& value) const {
+  uint64_t offset = readLE(this->base + this->indexOffset + (i * 8), 8);
+  if (offset < magic.size() || offset + 8 > this->indexOffset) return false;
+  uint64_t keySize = readLE(this->base + offset, 4);
+  uint64_t valueSize = readLE(this->base + offset + 4, 4);
+  if (offset + 8 + keySize + valueSize > this->indexOffset) return false;
+  key = std::string_view(this->base + offset + 8, keySize);
+  value = std::string_view(this->base + offset + 8 + keySize, valueSize);
+  return true;
+}
+
+uint64_t TableBackend::lowerBound(std::string_view key) const {
+  uint64_t lo = 0, hi = this->count;
+  while (lo < hi) {
+    uint64_t mid = lo + (hi - lo) / 2;
+    std::string_view k, v;
+    if (this->entry(mid, k, v) && k < key) lo = mid + 1; else hi = mid;
+  }
+  return lo;
+}
+
+bool TableBackend::get(const std::string& key, std::string& value, const Snapshot* /*snap*/) const {
+  uint64_t i = this->lowerBound(key);
+  std::string_view k, v;
+  if (i >= this->count || !this->entry(i, k, v) || k != key) return false;
+  value.assign(v.data(), v.size());
+  return true;
+}
+
+bool TableBackend::write(const std::vector<Write>& /*writes*/, bool /*sync*/, std::string& error) {
+  error = "Table databases are read-only";
+  return false;
+}
+
+std::unique_ptr<DBBackend::Iterator> TableBackend::iterator(const Snapshot* /*snap*/) const {
+  return std::make_unique<TableIterator>(
+    std::static_pointer_cast<const TableBackend>(this->shared_from_this())
+  );
+}
+
+std::shared_ptr<const DBBackend::Snapshot> TableBackend::snapshot() const {
+  // Tables never change, so every read is already consistent
+  return std::make_shared<DBBackend::Snapshot>();
+}
+
+TableBackend::Writer::Writer(const boost::filesystem::path& path)
+  : out(path.string(), std::ios::binary | std::ios::trunc)
+{
+  this->out.write(magic.data(), magic.size());
+  this->offset = magic.size();
+}
+
+bool TableBackend::Writer::add(std::string_view key, std::string_view value) {
+  if (!this->out || (!this->index.empty() && key <= this->lastKey)) return false;
+  if (key.size() > UINT32_MAX || value.size() > UINT32_MAX) return false;
+  std::string header;
+  writeLE(header, key.size(), 4);
+  writeLE(header, value.size(), 4);
+  this->out.write(header.data(), header.size());
+  this->out.write(key.data(), key.size());
+  this->out.write(value.data(), value.size());
+  this->index.push_back(this->offset);
+  this->offset += header.size() + key.size() + value.size();
+  this->lastKey.assign(key.data(), key.size());
+  return bool(this->out);
+}
+
+bool TableBackend::Writer::finish() {
+  if (!this->out) return false;
+  std::string tail;
+  tail.reserve((this->index.size() * 8) + 16 + magic.size());
+  for (uint64_t offset : this->index) writeLE(tail, offset, 8);
+  writeLE(tail, this->offset, 8);
+  writeLE(tail, this->index.size(), 8);
+  tail += magic;
+  this->out.write(tail.data(), tail.size());
+  this->out.close();
+  return !this->out.fail();
+}
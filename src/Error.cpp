@@ -37,6 +37,14 @@ const std::map<uint64_t, std::string> Error::codeMap = {
   {33, "JSON File Does Not Exist"},
   {34, "JSON File Read Error"},
   {35, "JSON File Write Error"},
+  {36, "RPC Batch Request Failed"},
+  {37, "Transaction Receipt Timeout"},
+  {38, "Transaction Reverted"},
+  {39, "ABI Invalid Encoded Data"},
+  {40, "ABI Unknown Error Selector"},
+  {41, "ABI Unknown Event"},
+  {42, "ABI Invalid Int"},
+  {43, "RPC Request Failed"},
   {999, "Unknown Error"}
 };
 
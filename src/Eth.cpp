@@ -1,5 +1,99 @@
 #include <web3cpp/Eth.h>
 
+namespace {
+  /**
+   * Read a quantity (e.g. a balance) from a batch response.
+   * @param &res The response.
+   * @param &out Set to the quantity.
+   * @return `false` if there's no result or it's not a valid 256-bit hex quantity.
+   */
+  bool readQuantity(const json& res, BigNumber& out) {
+    if (!res.is_object() || !res.contains("result") || !res["result"].is_string()) return false;
+    const std::string& hex = res["result"].get_ref<const std::string&>();
+    if (hex.size() <= 2 || hex.size() > 66 || !Utils::isHexStrict(hex)) return false;
+    out = Utils::hexToBigNumber(hex);
+    return true;
+  }
+}
+
+std::vector<json> Eth::_sendBatch(const json& requests, uint64_t start, uint64_t end) {
+  json batch = json::array();
+  for (uint64_t i = start; i < end; i++) {
+    json req = requests[i];
+    req["id"] = i;
+    batch.push_back(req);
+  }
+  json res;
+  try {
+    res = json::parse(Net::HTTPRequest(
+      this->provider, Net::RequestTypes::POST, batch.dump()
+    ));
+  } catch (std::exception &e) {
+    res["error"]["message"] = e.what();
+  } catch (std::string &e) {
+    res["error"]["message"] = e;
+  }
+
+  // Nodes may answer batches out of order, match them back by id.
+  // A non-array answer means the whole batch was rejected.
+  std::vector<json> ret(end - start);
+  if (res.is_array()) {
+    for (json& item : res) {
+      if (!item.contains("id") || !item["id"].is_number_unsigned()) continue;
+      uint64_t id = item["id"].get<uint64_t>();
+      if (id >= start && id < end) ret[id - start] = std::move(item);
+    }
+  }
+  for (json& item : ret) {
+    if (item.is_null()) {
+      if (!res.is_array() && res.contains("error")) {
+        item["error"] = res["error"];
+      } else {
+        item["error"]["message"] = "Missing response in batch";
+      }
+    }
+  }
+  return ret;
+}
+
+json Eth::_batchRequest(
+  const json& requests, unsigned int batchSize, unsigned int maxConcurrency
+) {
+  json ret = json::array();
+  if (batchSize == 0) batchSize = 1;
+  if (maxConcurrency == 0) maxConcurrency = 1;
+
+  // Keep at most maxConcurrency batches in flight, collecting them in order
+  std::deque<std::future<std::vector<json>>> inFlight;
+  auto collect = [&]{
+    for (json& item : inFlight.front().get()) ret.push_back(std::move(item));
+    inFlight.pop_front();
+  };
+  for (uint64_t start = 0; start < requests.size(); start += batchSize) {
+    uint64_t end = std::min<uint64_t>(start + batchSize, requests.size());
+    if (inFlight.size() >= maxConcurrency) collect();
+    inFlight.push_back(std::async(std::launch::async, [this, &requests, start, end]{
+      return this->_sendBatch(requests, start, end);
+    }));
+  }
+  while (!inFlight.empty()) collect();
+  return ret;
+}
+
+std::string Eth::_pinBlock(const std::string& block) {
+  if (block != "latest" && block != "pending") return block;
+  try {
+    json res = json::parse(Net::HTTPRequest(
+      this->provider, Net::RequestTypes::POST, RPC::eth_blockNumber().dump()
+    ));
+    if (res.contains("result") && res["result"].is_string()) {
+      return res["result"].get<std::string>();
+    }
+  } catch (std::exception &e) {
+  } catch (std::string &e) {}
+  return "";
+}
+
 std::future<json> Eth::getProtocolVersion() {
   return std::async([=]{
     return json::parse(Net::HTTPRequest(
@@ -90,10 +184,82 @@ std::future<json> Eth::getBalance(const std::string& address, const std::string&
   });
 }
 
+std::future<std::vector<BigNumber>> Eth::getBalances(
+  const std::vector<std::string>& addresses, Error &err,
+  const std::string& defaultBlock, unsigned int batchSize, unsigned int maxConcurrency,
+  std::vector<bool>* failed
+) {
+  return std::async([=, &err]{
+    if (failed != nullptr) failed->assign(addresses.size(), true);
+    std::vector<BigNumber> ret(addresses.size(), 0);
+    std::string block = this->_pinBlock(
+      (!defaultBlock.empty()) ? defaultBlock : this->defaultBlock
+    );
+    if (block.empty()) { err.setCode(36); return ret; } // RPC Batch Request Failed
+
+    json requests = json::array();
+    for (const std::string& address : addresses) {
+      Error rpcErr;
+      json req = RPC::eth_getBalance(address, block, rpcErr);
+      if (rpcErr.getCode() != 0) { err.setCode(rpcErr.getCode()); return ret; }
+      requests.push_back(std::move(req));
+    }
+
+    json responses = this->_batchRequest(requests, batchSize, maxConcurrency);
+    bool allRead = true;
+    for (uint64_t i = 0; i < addresses.size(); i++) {
+      if (!readQuantity(responses[i], ret[i])) { allRead = false; continue; }
+      if (failed != nullptr) (*failed)[i] = false;
+    }
+    err.setCode((allRead) ? 0 : 36); // RPC Batch Request Failed
+    return ret;
+  });
+}
+
+std::future<std::vector<BigNumber>> Eth::getTokenBalances(
+  const std::string& token, const std::vector<std::string>& addresses,
+  Error &err, const std::string& defaultBlock,
+  unsigned int batchSize, unsigned int maxConcurrency, std::vector<bool>* failed
+) {
+  return std::async([=, &err]{
+    if (failed != nullptr) failed->assign(addresses.size(), true);
+    std::vector<BigNumber> ret(addresses.size(), 0);
+    std::string block = this->_pinBlock(
+      (!defaultBlock.empty()) ? defaultBlock : this->defaultBlock
+    );
+    if (block.empty()) { err.setCode(36); return ret; } // RPC Batch Request Failed
+
+    // eth_call requires a "from" address, any valid one will do for views
+    std::string from = (Utils::isAddress(this->defaultAccount))
+      ? this->defaultAccount : "0x0000000000000000000000000000000000000000";
+    std::string selector = "0x" + Solidity::packFunction("balanceOf(address)");
+    json requests = json::array();
+    for (const std::string& address : addresses) {
+      Error rpcErr;
+      if (!Utils::isAddress(address)) { err.setCode(5); return ret; } // Invalid Address
+      json callObj = {
+        {"from", from}, {"to", token}, {"data", selector + Solidity::packAddress(address)}
+      };
+      json req = RPC::eth_call(callObj, block, rpcErr);
+      if (rpcErr.getCode() != 0) { err.setCode(rpcErr.getCode()); return ret; }
+      requests.push_back(std::move(req));
+    }
+
+    json responses = this->_batchRequest(requests, batchSize, maxConcurrency);
+    bool allRead = true;
+    for (uint64_t i = 0; i < addresses.size(); i++) {
+      if (!readQuantity(responses[i], ret[i])) { allRead = false; continue; }
+      if (failed != nullptr) (*failed)[i] = false;
+    }
+    err.setCode((allRead) ? 0 : 36); // RPC Batch Request Failed
+    return ret;
+  });
+}
+
 std::future<json> Eth::getStorageAt(
   std::string address, std::string position, const std::string& defaultBlock
 ) {
-  if (position.substr(0, 2) != "0x" || position.substr(0, 2) != "0X") {
+  if (position.substr(0, 2) != "0x" && position.substr(0, 2) != "0X") {
     position.insert(0, "0x");
   }
   return std::async([=]{
@@ -116,9 +282,52 @@ std::future<json> Eth::getStorageAt(
 std::future<json> Eth::getStorageAt(
   const std::string& address, const BigNumber& position, const std::string& defaultBlock
 ) {
-  std::stringstream ss;
-  ss << std::hex << position;
-  return getStorageAt(address, ss.str(), defaultBlock);
+  return getStorageAt(address, "0x" + Utils::toHex(position), defaultBlock);
+}
+
+std::future<std::map<dev::h256, dev::h256>> Eth::getStorageSnapshot(
+  const std::string& address, const std::vector<dev::h256>& slots, Error &err,
+  const std::string& defaultBlock, unsigned int batchSize
+) {
+  return std::async([=, &err]{
+    std::map<dev::h256, dev::h256> ret;
+    std::string block = this->_pinBlock(
+      (!defaultBlock.empty()) ? defaultBlock : this->defaultBlock
+    );
+    if (block.empty()) { err.setCode(36); return ret; } // RPC Batch Request Failed
+
+    // Build every request upfront, positions are always 32 bytes in hex
+    json requests = json::array();
+    for (const dev::h256& slot : slots) {
+      Error rpcErr;
+      json req = RPC::eth_getStorageAt(address, "0x" + slot.hex(), block, rpcErr);
+      if (rpcErr.getCode() != 0) { err.setCode(rpcErr.getCode()); return ret; }
+      requests.push_back(std::move(req));
+    }
+
+    json responses = this->_batchRequest(requests, batchSize);
+    bool allRead = true;
+    for (uint64_t i = 0; i < slots.size(); i++) {
+      const json& res = responses[i];
+      if (!res.contains("result") || !res["result"].is_string()) {
+        allRead = false; continue;
+      }
+      ret.emplace(slots[i], dev::h256(
+        dev::fromHex(res["result"].get<std::string>()), dev::h256::AlignRight
+      ));
+    }
+    err.setCode((allRead) ? 0 : 36); // RPC Batch Request Failed
+    return ret;
+  });
+}
+
+std::future<std::map<dev::h256, dev::h256>> Eth::getStorageSnapshot(
+  const std::string& address, const dev::h256& startSlot, uint64_t count,
+  Error &err, const std::string& defaultBlock, unsigned int batchSize
+) {
+  return getStorageSnapshot(
+    address, Storage::slotRange(startSlot, count), err, defaultBlock, batchSize
+  );
 }
 
 std::future<json> Eth::getCode(const std::string& address, const std::string& defaultBlock) {
@@ -449,6 +658,12 @@ std::future<json> Eth::submitWork(
   });
 }
 
+std::future<json> Eth::batchRequest(const json& requests, unsigned int batchSize) {
+  return std::async([=]{
+    return this->_batchRequest(requests, batchSize);
+  });
+}
+
 uint64_t Eth::getChainId() {
   return this->provider->getChainId();
 }
@@ -0,0 +1,124 @@
+#include <web3cpp/FeeOracle.h>
+
+namespace {
+  // Read a quantity from a response field, which must be a valid hex string
+  bool readQuantity(const json& value, BigNumber& out) {
+    if (!value.is_string()) return false;
+    const std::string& str = value.get_ref<const std::string&>();
+    if (str.size() <= 2 || str.size() > 66 || !Utils::isHexStrict(str)) return false;
+    out = Utils::hexToBigNumber(str);
+    return true;
+  }
+}
+
+FeeOracle::FeeOracle(
+  BlockWatcher& _watcher, std::vector<double> _percentiles, unsigned int _historyBlocks
+) : watcher(_watcher), eth(_watcher.getProvider()),
+  percentiles(std::move(_percentiles)),
+  historyBlocks((_historyBlocks > 0) ? _historyBlocks : 1)
+{
+  if (this->percentiles.empty()) throw std::invalid_argument("no priority fee percentiles");
+  for (double p : this->percentiles) {
+    // Also catches NaN, which fails every comparison
+    if (!(p >= 0 && p <= 100)) throw std::invalid_argument("priority fee percentile out of range (0-100)");
+  }
+  std::sort(this->percentiles.begin(), this->percentiles.end());
+  this->percentiles.erase(
+    std::unique(this->percentiles.begin(), this->percentiles.end()), this->percentiles.end()
+  );
+  this->subId = this->watcher.subscribe([this](uint64_t head){ this->refresh(head); });
+}
+
+FeeOracle::~FeeOracle() {
+  this->watcher.unsubscribe(this->subId);
+}
+
+bool FeeOracle::refresh(uint64_t head) {
+  std::string headHex = "0x" + Utils::toHex(BigNumber(head));
+  Error historyErr, blockErr;
+  json requests = json::array();
+  requests.push_back(RPC::eth_gasPrice());
+  requests.push_back(RPC::eth_feeHistory(this->historyBlocks, headHex, this->percentiles, historyErr));
+  requests.push_back(RPC::eth_getBlockByNumber(headHex, false, blockErr));
+  if (historyErr.getCode() != 0 || blockErr.getCode() != 0) return false;
+  json responses = this->eth.batchRequest(requests).get();
+  if (!responses.is_array() || responses.size() != 3) return false;
+  return this->update(head, responses[0], responses[1], responses[2]);
+}
+
+bool FeeOracle::update(uint64_t head, const json& price, const json& history, const json& block) {
+  std::shared_ptr<Snapshot> s = std::make_shared<Snapshot>();
+  s->block = head;
+  s->percentiles = this->percentiles;
+  if (!price.is_object() || !price.contains("result")) return false;
+  if (!readQuantity(price["result"], s->gasPrice)) return false;
+  if (block.is_object() && block.contains("result") && block["result"].is_object()
+    && block["result"].contains("baseFeePerGas")
+  ) {
+    if (!readQuantity(block["result"]["baseFeePerGas"], s->baseFee)) return false;
+    s->nextBaseFee = s->baseFee;
+  }
+
+  // Fee history is optional (pre-London chains or nodes without it),
+  // suggestions fall back to the node's gas price when it's missing.
+  // If it's there, it has to be valid as a whole.
+  if (history.is_object() && history.contains("result") && history["result"].is_object()) {
+    const json& res = history["result"];
+    if (res.contains("baseFeePerGas")) {
+      const json& baseFees = res["baseFeePerGas"];
+      if (!baseFees.is_array()) return false;
+      // The last entry is the base fee of the block after the newest one
+      if (!baseFees.empty() && !readQuantity(baseFees.back(), s->nextBaseFee)) return false;
+    }
+    if (res.contains("reward")) {
+      const json& rewards = res["reward"];
+      if (!rewards.is_array()) return false;
+      std::vector<std::vector<BigNumber>> samples(this->percentiles.size());
+      for (std::vector<BigNumber>& sample : samples) sample.reserve(rewards.size());
+      for (const json& blockRewards : rewards) {
+        if (!blockRewards.is_array()) return false;
+        for (uint64_t p = 0; p < samples.size() && p < blockRewards.size(); p++) {
+          BigNumber fee;
+          if (!readQuantity(blockRewards[p], fee)) return false;
+          samples[p].push_back(fee);
+        }
+      }
+      for (std::vector<BigNumber>& sample : samples) {
+        if (sample.empty()) { s->priorityFees.clear(); break; }
+        // Median over the window smooths out single-block spikes
+        std::nth_element(sample.begin(), sample.begin() + (sample.size() / 2), sample.end());
+        s->priorityFees.push_back(sample[sample.size() / 2]);
+      }
+    }
+  }
+
+  std::atomic_store(&this->snap, std::shared_ptr<const Snapshot>(std::move(s)));
+  return true;
+}
+
+BigNumber FeeOracle::priorityFeeFor(const Snapshot& s, double percentile) {
+  if (s.priorityFees.empty() || s.priorityFees.size() != s.percentiles.size()) return 0;
+  uint64_t best = 0;
+  for (uint64_t i = 1; i < s.percentiles.size(); i++) {
+    if (std::abs(s.percentiles[i] - percentile) < std::abs(s.percentiles[best] - percentile)) best = i;
+  }
+  return s.priorityFees[best];
+}
+
+BigNumber FeeOracle::maxPriorityFee(double percentile) const {
+  std::shared_ptr<const Snapshot> s = this->snapshot();
+  return (s) ? priorityFeeFor(*s, percentile) : BigNumber(0);
+}
+
+BigNumber FeeOracle::maxFee(double percentile) const {
+  std::shared_ptr<const Snapshot> s = this->snapshot();
+  if (!s) return 0;
+  return (s->nextBaseFee * 2) + priorityFeeFor(*s, percentile);
+}
+
+BigNumber FeeOracle::gasPrice(double percentile) const {
+  std::shared_ptr<const Snapshot> s = this->snapshot();
+  if (!s) return 0;
+  BigNumber dynamic = (s->nextBaseFee > 0) ? s->nextBaseFee + priorityFeeFor(*s, percentile) : BigNumber(0);
+  return std::max(s->gasPrice, dynamic);
+}
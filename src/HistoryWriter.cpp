@@ -0,0 +1,88 @@
+#include <web3cpp/HistoryWriter.h>
+
+HistoryWriter::HistoryWriter(const Database& _db, uint64_t _maxBatch, uint64_t capacity)
+  : db(_db), maxBatch((_maxBatch > 0) ? _maxBatch : 1), queue(capacity)
+{
+  this->worker = std::thread([this]{ this->run(); });
+}
+
+HistoryWriter::~HistoryWriter() {
+  this->queue.close();
+  if (this->worker.joinable()) this->worker.join();
+}
+
+bool HistoryWriter::enqueue(const TxIndex& history, std::string signedTx) {
+  Item item;
+  item.history = history;
+  item.signedTx = std::move(signedTx);
+  item.unixDate = std::chrono::duration_cast<std::chrono::seconds>(
+    std::chrono::system_clock::now().time_since_epoch()
+  ).count();
+  return this->queue.push(std::move(item));
+}
+
+bool HistoryWriter::flush() {
+  std::unique_lock<std::mutex> lock(this->flushLock);
+  uint64_t ticket = ++this->nextBarrier;
+  lock.unlock();
+  Item barrier;
+  barrier.barrier = ticket;
+  if (!this->queue.push(std::move(barrier))) return false;
+  lock.lock();
+  this->flushed.wait(lock, [this, ticket]{ return this->doneBarrier >= ticket; });
+  bool ok = !this->failed;
+  this->failed = false;
+  return ok;
+}
+
+bool HistoryWriter::add(Database::Batch& batch, const Item& item) {
+  TxRecord record;
+  try {
+    record = TxRecord::fromSignedTx(item.signedTx);
+  } catch (std::exception &e) {
+    std::cout << "Error decoding transaction for history: " << e.what() << std::endl;
+    return false;
+  }
+  record.unixDate = item.unixDate;
+  // Histories from another database can't join the batch. They're synced
+  // right away, as a later flush() only syncs the writer's own database.
+  if (!item.history.add(batch, record)) {
+    Database::Batch own = item.history.db().batch();
+    return item.history.add(own, record) && own.commit(true);
+  }
+  return true;
+}
+
+void HistoryWriter::run() {
+  bool unsynced = false;  // Written since the last sync
+  Item item;
+  while (this->queue.pop(item)) {
+    Database::Batch batch = this->db.batch();
+    uint64_t barrier = 0, taken = 0;
+    bool ok = true;
+    // Take whatever else is already queued, so one write covers it all
+    do {
+      if (item.barrier > 0) {
+        barrier = std::max(barrier, item.barrier);
+      } else if (!this->add(batch, item)) {
+        ok = false;
+      }
+    } while (++taken < this->maxBatch && this->queue.tryPop(item));
+
+    bool sync = (barrier > 0);
+    if (batch.size() > 0 || (sync && unsynced)) {
+      if (batch.commit(sync)) {
+        unsynced = !sync;
+      } else {
+        ok = false;
+      }
+    }
+    if (!ok || barrier > 0) {
+      std::lock_guard<std::mutex> lock(this->flushLock);
+      if (!ok) this->failed = true;
+      this->doneBarrier = std::max(this->doneBarrier, barrier);
+    }
+    if (barrier > 0) this->flushed.notify_all();
+  }
+  if (unsynced) this->db.batch().commit(true);
+}
@@ -0,0 +1,218 @@
+#include <web3cpp/NonceManager.h>
+
+const std::string NonceManager::dbKey = "_nonceState";
+
+std::string NonceManager::_pendingKey(uint64_t nonce) {
+  // Fixed width hex, so the keys sort in nonce order
+  static const char digits[] = "0123456789abcdef";
+  std::string ret = "_nonce/0000000000000000";
+  for (size_t i = 0; i < 16; i++, nonce >>= 4) ret[ret.size() - 1 - i] = digits[nonce & 0xF];
+  return ret;
+}
+
+bool NonceManager::_fetch(uint64_t& out, Error &err) const {
+  if (this->provider == nullptr) { err.setCode(43); return false; } // RPC Request Failed
+  Error rpcErr;
+  std::string rpcStr = RPC::eth_getTransactionCount(
+    this->address, "pending", rpcErr
+  ).dump();
+  if (rpcErr.getCode() != 0) { err.setCode(rpcErr.getCode()); return false; }
+  json res;
+  try {
+    res = json::parse(Net::HTTPRequest(
+      this->provider, Net::RequestTypes::POST, rpcStr
+    ));
+  } catch (std::exception &e) {
+    err.setCode(43); return false;  // RPC Request Failed
+  } catch (std::string &e) {
+    err.setCode(43); return false;  // RPC Request Failed
+  }
+  if (!res.is_object() || !res.contains("result") || !res["result"].is_string()) {
+    err.setCode(43); return false;  // RPC Request Failed
+  }
+  const std::string& result = res["result"].get_ref<const std::string&>();
+  if (result.size() <= 2 || result.size() > 18 || !Utils::isHexStrict(result)) {
+    err.setCode(43); return false;  // RPC Request Failed
+  }
+  out = boost::lexical_cast<HexTo<uint64_t>>(result);
+  err.setCode(0);
+  return true;
+}
+
+void NonceManager::_apply(uint64_t networkNonce) {
+  Database::Batch batch = this->db.batch();
+  if (!this->synced) {
+    // Nothing can be in flight before the first sync, so anything at or
+    // above the network count never made it and can be handed out again
+    for (auto it = this->pendingTxs.lower_bound(networkNonce); it != this->pendingTxs.end();) {
+      batch.del(_pendingKey(it->first));
+      it = this->pendingTxs.erase(it);
+    }
+    this->nextNonce = networkNonce;
+    this->synced = true;
+  } else if (networkNonce > this->nextNonce) {
+    this->nextNonce = networkNonce;
+  }
+  // The node already has something for every nonce below its count
+  this->gaps.erase(this->gaps.begin(), this->gaps.lower_bound(networkNonce));
+  this->_saveState(batch);
+  if (this->db.isOpen()) batch.commit();
+}
+
+bool NonceManager::_load() {
+  if (!this->db.isOpen()) return false;
+  std::string stored = this->db.getKeyValue(NonceManager::dbKey);
+  if (stored.empty()) return false;
+  try {
+    json state = json::parse(stored);
+    this->nextNonce = state["next"].get<uint64_t>();
+    this->gaps.clear();
+    if (state.contains("gaps")) {
+      for (const json& gap : state["gaps"]) this->gaps.insert(gap.get<uint64_t>());
+    }
+  } catch (std::exception &e) {
+    return false;
+  }
+  this->pendingTxs.clear();
+  Database::Range range;
+  range.prefix = "_nonce/";
+  for (Database::Cursor c = this->db.cursor(range); c.valid(); c.next()) {
+    std::string_view key = c.key().substr(range.prefix.size());
+    try {
+      uint64_t nonce = boost::lexical_cast<HexTo<uint64_t>>(std::string(key));
+      this->pendingTxs[nonce] = std::string(c.value());
+    } catch (std::exception &e) {
+      continue;
+    }
+  }
+  return true;
+}
+
+void NonceManager::_saveState(Database::Batch& batch) const {
+  json state;
+  state["next"] = this->nextNonce;
+  state["gaps"] = this->gaps;
+  batch.put(NonceManager::dbKey, state.dump());
+}
+
+void NonceManager::_release(uint64_t nonce, Database::Batch& batch) {
+  batch.del(_pendingKey(nonce));
+  if (nonce + 1 == this->nextNonce) {
+    // The highest one outstanding, so the counter can go back,
+    // along with any gaps right below it
+    this->nextNonce--;
+    while (!this->gaps.empty() && *this->gaps.rbegin() + 1 == this->nextNonce) {
+      this->gaps.erase(std::prev(this->gaps.end()));
+      this->nextNonce--;
+    }
+  } else if (nonce < this->nextNonce) {
+    this->gaps.insert(nonce);
+  }
+}
+
+uint64_t NonceManager::next(Error &err) {
+  std::unique_lock<std::mutex> lock(this->nonceLock);
+  if (!this->synced) {
+    // A persisted state may be stale (e.g. transactions sent elsewhere),
+    // so the network always has the final word. The stored state is only
+    // used to keep tracking hashes of transactions sent before a restart,
+    // or as a fallback if the network can't be reached.
+    uint64_t networkNonce;
+    Error syncErr;
+    if (this->_fetch(networkNonce, syncErr)) {
+      this->_apply(networkNonce);
+    } else {
+      if (!this->stored) { err.setCode(syncErr.getCode()); return 0; }
+      this->synced = true;
+    }
+  }
+  // Fill gaps left by failed transactions first, so later ones aren't stuck
+  uint64_t ret;
+  if (!this->gaps.empty()) {
+    ret = *this->gaps.begin();
+    this->gaps.erase(this->gaps.begin());
+  } else {
+    ret = this->nextNonce++;
+  }
+  this->pendingTxs.emplace(ret, "");
+  if (this->db.isOpen()) {
+    Database::Batch batch = this->db.batch();
+    batch.put(_pendingKey(ret), "");
+    this->_saveState(batch);
+    batch.commit();
+  }
+  err.setCode(0);
+  return ret;
+}
+
+uint64_t NonceManager::peek() const {
+  std::lock_guard<std::mutex> lock(this->nonceLock);
+  return (!this->gaps.empty()) ? *this->gaps.begin() : this->nextNonce;
+}
+
+bool NonceManager::isSynced() const {
+  std::lock_guard<std::mutex> lock(this->nonceLock);
+  return this->synced;
+}
+
+void NonceManager::markSent(uint64_t nonce, const std::string& txHash) {
+  std::lock_guard<std::mutex> lock(this->nonceLock);
+  this->pendingTxs[nonce] = txHash;
+  if (this->db.isOpen()) this->db.putKeyValue(_pendingKey(nonce), txHash);
+}
+
+void NonceManager::markConfirmed(uint64_t nonce) {
+  std::lock_guard<std::mutex> lock(this->nonceLock);
+  Database::Batch batch = this->db.batch();
+  auto end = this->pendingTxs.upper_bound(nonce);
+  for (auto it = this->pendingTxs.begin(); it != end; it++) batch.del(_pendingKey(it->first));
+  this->pendingTxs.erase(this->pendingTxs.begin(), end);
+  this->gaps.erase(this->gaps.begin(), this->gaps.upper_bound(nonce));
+  if (this->nextNonce <= nonce) this->nextNonce = nonce + 1;
+  this->_saveState(batch);
+  if (this->db.isOpen()) batch.commit();
+}
+
+void NonceManager::markFailed(uint64_t nonce) {
+  std::lock_guard<std::mutex> lock(this->nonceLock);
+  if (this->pendingTxs.erase(nonce) == 0) return;  // Not handed out, or already released
+  Database::Batch batch = this->db.batch();
+  this->_release(nonce, batch);
+  this->_saveState(batch);
+  if (this->db.isOpen()) batch.commit();
+}
+
+uint64_t NonceManager::fillGap(uint64_t nonce) {
+  std::lock_guard<std::mutex> lock(this->nonceLock);
+  if (this->gaps.empty() || *this->gaps.begin() >= nonce) return nonce;
+  if (this->pendingTxs.count(nonce) == 0) return nonce;  // Not handed out here
+  uint64_t ret = *this->gaps.begin();
+  this->gaps.erase(this->gaps.begin());
+  this->pendingTxs.erase(nonce);
+  this->pendingTxs.emplace(ret, "");
+  Database::Batch batch = this->db.batch();
+  batch.put(_pendingKey(ret), "");
+  this->_release(nonce, batch);
+  this->_saveState(batch);
+  if (this->db.isOpen()) batch.commit();
+  return ret;
+}
+
+void NonceManager::sync(uint64_t networkNonce) {
+  std::lock_guard<std::mutex> lock(this->nonceLock);
+  this->_apply(networkNonce);
+}
+
+bool NonceManager::resync(Error &err) {
+  // The request is made without the lock, nonces can still be handed out meanwhile
+  uint64_t networkNonce;
+  if (!this->_fetch(networkNonce, err)) return false;
+  std::lock_guard<std::mutex> lock(this->nonceLock);
+  this->_apply(networkNonce);
+  return true;
+}
+
+std::map<uint64_t, std::string> NonceManager::pending() const {
+  std::lock_guard<std::mutex> lock(this->nonceLock);
+  return this->pendingTxs;
+}
@@ -297,6 +297,25 @@ json RPC::eth_estimateGas(const json& callObject, Error &err) {
     : _buildJSON("eth_estimateGas", {callObject});
 }
 
+json RPC::eth_feeHistory(
+  uint64_t blockCount, const std::string& newestBlock,
+  const std::vector<double>& rewardPercentiles, Error &err
+) {
+  int errCode = 0;
+  [&](){
+    if (!_checkDefaultBlock(newestBlock)) { errCode = 9; return; } // Invalid Block Number
+    for (uint64_t i = 0; i < rewardPercentiles.size(); i++) {
+      if (
+        rewardPercentiles[i] < 0 || rewardPercentiles[i] > 100 ||
+        (i > 0 && rewardPercentiles[i] < rewardPercentiles[i - 1])
+      ) { errCode = 10; return; } // Invalid Number
+    }
+  }();
+  err.setCode(errCode);
+  return (err.getCode() != 0) ? json::object()
+    : _buildJSON("eth_feeHistory", {"0x" + Utils::toHex(BigNumber(blockCount)), newestBlock, rewardPercentiles});
+}
+
 json RPC::eth_getBlockByHash(const std::string& hash, bool returnTransactionObjects, Error &err) {
   int errCode = 0;
   [&](){
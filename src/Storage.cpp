@@ -0,0 +1,30 @@
+#include <web3cpp/Storage.h>
+
+dev::h256 Storage::mappingSlot(const dev::h256& key, const dev::h256& slot) {
+  dev::bytes preimage(64);
+  std::copy(key.begin(), key.end(), preimage.begin());
+  std::copy(slot.begin(), slot.end(), preimage.begin() + 32);
+  return dev::sha3(preimage);
+}
+
+dev::h256 Storage::mappingSlot(const dev::Address& key, const dev::h256& slot) {
+  return mappingSlot(dev::h256(key, dev::h256::AlignRight), slot);
+}
+
+dev::h256 Storage::arraySlot(
+  const dev::h256& slot, const BigNumber& index, unsigned int slotsPerElement
+) {
+  // Slot arithmetic wraps around 2^256, same as the EVM
+  BigNumber base = BigNumber(dev::sha3(slot));
+  return dev::h256(BigNumber(base + (index * slotsPerElement)));
+}
+
+std::vector<dev::h256> Storage::slotRange(const dev::h256& start, uint64_t count) {
+  std::vector<dev::h256> ret;
+  ret.reserve(count);
+  BigNumber first = BigNumber(start);
+  for (uint64_t i = 0; i < count; i++) {
+    ret.emplace_back(BigNumber(first + i));
+  }
+  return ret;
+}
@@ -0,0 +1,63 @@
+#include <web3cpp/TimerService.h>
+
+TimerService::TimerService() : work(boost::asio::make_work_guard(ioc)) {
+  this->runner = std::thread([this]{ this->ioc.run(); });
+}
+
+TimerService& TimerService::instance() {
+  static TimerService service;
+  return service;
+}
+
+TimerService::~TimerService() {
+  {
+    std::lock_guard<std::mutex> lock(this->timerLock);
+    this->timers.clear();
+  }
+  this->work.reset();
+  this->ioc.stop();
+  if (this->runner.joinable()) this->runner.join();
+}
+
+TimerService::TimerId TimerService::schedule(
+  std::chrono::milliseconds delay, std::function<void()> task
+) {
+  std::shared_ptr<boost::asio::steady_timer> timer =
+    std::make_shared<boost::asio::steady_timer>(this->ioc, delay);
+  std::lock_guard<std::mutex> lock(this->timerLock);
+  TimerId id = this->nextId++;
+  this->timers.emplace(id, timer);
+  timer->async_wait([this, id, timer, task = std::move(task)](const boost::system::error_code& ec){
+    {
+      // A task that was cancelled is no longer in the map, even if
+      // its timer fired before the cancellation reached the io_context
+      std::lock_guard<std::mutex> lock(this->timerLock);
+      if (ec || !this->timers.erase(id)) return;
+      this->runningId = id;
+    }
+    task();
+    {
+      std::lock_guard<std::mutex> lock(this->timerLock);
+      this->runningId = 0;
+    }
+    this->doneCv.notify_all();
+  });
+  return id;
+}
+
+bool TimerService::cancel(TimerId id) {
+  if (id == 0) return false;
+  std::unique_lock<std::mutex> lock(this->timerLock);
+  auto it = this->timers.find(id);
+  if (it != this->timers.end()) {
+    std::shared_ptr<boost::asio::steady_timer> timer = it->second;
+    this->timers.erase(it);
+    // Timers aren't thread-safe, so the actual cancel runs on the timer thread
+    boost::asio::post(this->ioc, [timer]{ timer->cancel(); });
+    return true;
+  }
+  if (std::this_thread::get_id() != this->runner.get_id()) {
+    this->doneCv.wait(lock, [this, id]{ return this->runningId != id; });
+  }
+  return false;
+}
@@ -0,0 +1,121 @@
+#include <web3cpp/TxIndex.h>
+
+const std::string TxIndex::prefix = "_idx/";
+
+namespace {
+  /// Encode a number as fixed-width hex, so keys sort in numeric order.
+  std::string sortable(uint64_t n) {
+    static const char digits[] = "0123456789abcdef";
+    std::string ret(16, '0');
+    for (int i = 15; i >= 0 && n > 0; i--, n >>= 4) ret[i] = digits[n & 0xf];
+    return ret;
+  }
+
+  /// Get the index letter of a status.
+  char statusKey(TxIndex::Status status) {
+    switch (status) {
+      case TxIndex::Status::Confirmed: return 'c';
+      case TxIndex::Status::Invalid: return 'i';
+      default: return 'p';
+    }
+  }
+}
+
+std::vector<std::string> TxIndex::indexKeys(const TxRecord& record, const std::string& hash) const {
+  std::vector<std::string> ret;
+  std::string date = sortable(record.unixDate);
+  if (record.blockNumber > 0) {
+    ret.push_back(prefix + "block/" + sortable(record.blockNumber) + "/" + hash);
+  }
+  ret.push_back(prefix + "time/" + date + "/" + hash);
+  ret.push_back(prefix + "status/" + statusKey(TxIndex::status(record)) + "/" + date + "/" + hash);
+
+  // Counterparties: whoever is on the other side of the transaction
+  std::vector<dev::Address> parties { record.from };
+  try {
+    dev::eth::TransactionBase tx = record.tx();
+    if (!tx.isCreation()) {
+      parties.push_back(tx.to());
+    } else if (record.from) {
+      parties.push_back(dev::toAddress(record.from, tx.nonce()));
+    }
+  } catch (std::exception &e) {}  // Undecodable transactions are only indexed by sender
+  for (const dev::Address& party : parties) {
+    if (!party || party == this->owner) continue;
+    std::string key = prefix + "peer/" + party.hex() + "/" + date + "/" + hash;
+    if (std::find(ret.begin(), ret.end(), key) == ret.end()) ret.push_back(key);
+  }
+  return ret;
+}
+
+bool TxIndex::add(Database::Batch& batch, const TxRecord& record) const {
+  std::string hash = record.key();
+  std::vector<std::string> keys = this->indexKeys(record, hash);
+  TxRecord old;
+  if (this->get(hash, old)) {
+    for (const std::string& key : this->indexKeys(old, hash)) {
+      if (std::find(keys.begin(), keys.end(), key) != keys.end()) continue;
+      if (!batch.del(this->history, key)) return false;
+    }
+  }
+  if (!batch.put(this->history, hash, record.encode())) return false;
+  for (const std::string& key : keys) batch.put(this->history, key, "");
+  return true;
+}
+
+bool TxIndex::save(const TxRecord& record) {
+  Database::Batch batch = this->history.batch();
+  return this->add(batch, record) && batch.commit();
+}
+
+bool TxIndex::get(const std::string& hash, TxRecord& record) const {
+  std::string stored;
+  return this->history.getKeyValue(hash, stored) && TxRecord::fromStored(stored, record);
+}
+
+std::vector<TxRecord> TxIndex::scan(
+  const std::string& _prefix, uint64_t from, uint64_t to, uint64_t limit, bool reverse
+) const {
+  std::vector<TxRecord> ret;
+  if (from > to) return ret;
+  Database::Range range;
+  range.prefix = _prefix;
+  range.start = _prefix + sortable(from);
+  if (to < maxValue) range.end = _prefix + sortable(to + 1);
+  range.reverse = reverse;
+  // Reads go through one snapshot, so records match the index entries
+  Database view = this->history.snapshot();
+  TxRecord record;
+  for (Database::Cursor c = view.cursor(range); c.valid(); c.next()) {
+    std::string key(c.key());
+    std::string hash = key.substr(key.rfind('/') + 1);
+    std::string stored;
+    if (!view.getKeyValue(hash, stored) || !TxRecord::fromStored(stored, record)) continue;
+    // Skip entries that don't match the record anymore
+    std::vector<std::string> keys = this->indexKeys(record, hash);
+    if (std::find(keys.begin(), keys.end(), key) == keys.end()) continue;
+    ret.push_back(std::move(record));
+    if (limit > 0 && ret.size() >= limit) break;
+  }
+  return ret;
+}
+
+std::vector<TxRecord> TxIndex::byBlock(uint64_t first, uint64_t last, uint64_t limit, bool reverse) const {
+  return this->scan(prefix + "block/", first, last, limit, reverse);
+}
+
+std::vector<TxRecord> TxIndex::byTime(uint64_t since, uint64_t until, uint64_t limit, bool reverse) const {
+  return this->scan(prefix + "time/", since, until, limit, reverse);
+}
+
+std::vector<TxRecord> TxIndex::byCounterparty(
+  const dev::Address& party, uint64_t since, uint64_t until, uint64_t limit, bool reverse
+) const {
+  return this->scan(prefix + "peer/" + party.hex() + "/", since, until, limit, reverse);
+}
+
+std::vector<TxRecord> TxIndex::byStatus(
+  Status status, uint64_t since, uint64_t until, uint64_t limit, bool reverse
+) const {
+  return this->scan(prefix + "status/" + statusKey(status) + "/", since, until, limit, reverse);
+}
@@ -0,0 +1,276 @@
+#include <web3cpp/TxPipeline.h>
+
+TxPipeline::TxPipeline(Wallet& _wallet, const std::string& _password, Options _opts)
+  : wallet(_wallet), password(_password), opts(_opts), eth(_wallet.getProvider()),
+    buildQueue(_opts.queueSize), signQueue(_opts.queueSize),
+    sendQueue(_opts.queueSize), confirmQueue(_opts.queueSize)
+{
+  if (this->opts.signers == 0) {
+    this->opts.signers = std::max(1u, std::thread::hardware_concurrency());
+  }
+  if (this->opts.sendBatchSize == 0) this->opts.sendBatchSize = 1;
+  if (this->opts.receiptBatchSize == 0) this->opts.receiptBatchSize = 1;
+  this->activeSigners = this->opts.signers;
+  this->workers.emplace_back(&TxPipeline::buildLoop, this);
+  for (unsigned int i = 0; i < this->opts.signers; i++) {
+    this->workers.emplace_back(&TxPipeline::signLoop, this);
+  }
+  this->workers.emplace_back(&TxPipeline::sendLoop, this);
+  this->workers.emplace_back(&TxPipeline::confirmLoop, this);
+}
+
+TxPipeline::TxPipeline(Wallet& _wallet, const std::string& _password)
+  : TxPipeline(_wallet, _password, Options()) {}
+
+TxPipeline::~TxPipeline() {
+  this->wait();
+}
+
+void TxPipeline::buildLoop() {
+  Job job;
+  while (this->buildQueue.pop(job)) {
+    const std::unique_ptr<Account>& acc = this->wallet.getAccountDetails(job.req.from);
+    if (acc == nullptr) { this->finish(job, 11); continue; } // Transaction Build Error
+
+    // Nonces are only handed out here, in submission order
+    Error nonceErr;
+    job.nonce = acc->nonceManager().next(nonceErr);
+    if (nonceErr.getCode() != 0) { this->finish(job, nonceErr.getCode()); continue; }
+    Error buildErr;
+    job.skel = this->wallet.buildTransaction(
+      job.req.from, job.req.to, job.req.value, job.req.gasLimit,
+      job.req.gasPrice, job.req.dataHex, job.nonce, buildErr, job.req.creation
+    );
+    if (buildErr.getCode() != 0) {
+      this->releaseNonce(job);
+      this->finish(job, buildErr.getCode());
+      continue;
+    }
+    this->signQueue.push(std::move(job));
+  }
+  this->signQueue.close();
+}
+
+void TxPipeline::signLoop() {
+  Job job;
+  while (this->signQueue.pop(job)) {
+    this->fillGap(job);
+    Error signErr;
+    this->signJob(job, signErr);
+    if (signErr.getCode() != 0) {
+      this->releaseNonce(job);
+      this->finish(job, signErr.getCode());
+      continue;
+    }
+    this->sendQueue.push(std::move(job));
+  }
+  // Last signer out closes the next stage
+  if (--this->activeSigners == 0) this->sendQueue.close();
+}
+
+void TxPipeline::sendLoop() {
+  std::vector<Job> batch;
+  Job job;
+  while (this->sendQueue.pop(job)) {
+    batch.clear();
+    batch.push_back(std::move(job));
+    while (batch.size() < this->opts.sendBatchSize && this->sendQueue.tryPop(job)) {
+      batch.push_back(std::move(job));
+    }
+
+    // A lower nonce may have failed after these were signed,
+    // so move them down to it instead of sending them over the gap
+    for (auto it = batch.begin(); it != batch.end();) {
+      Error signErr;
+      if (this->fillGap(*it)) this->signJob(*it, signErr);
+      if (signErr.getCode() != 0) {
+        this->releaseNonce(*it);
+        this->finish(*it, signErr.getCode());
+        it = batch.erase(it);
+      } else {
+        it++;
+      }
+    }
+    if (batch.empty()) continue;
+
+    // Signers may finish out of order, so send lower nonces first
+    std::sort(batch.begin(), batch.end(), [](const Job& a, const Job& b){
+      return (a.nonce != b.nonce) ? a.nonce < b.nonce : a.id < b.id;
+    });
+    json requests = json::array();
+    for (const Job& j : batch) {
+      Error rpcErr;
+      requests.push_back(RPC::eth_sendRawTransaction(j.signedTx, rpcErr));
+    }
+    json responses = this->eth.batchRequest(requests, this->opts.sendBatchSize).get();
+
+    for (uint64_t i = 0; i < batch.size(); i++) {
+      Job& j = batch[i];
+      const json& res = responses[i];
+      if (!res.contains("result") || !res["result"].is_string()) {
+        this->releaseNonce(j);
+        this->finish(j, 13);  // Transaction Send Error
+        continue;
+      }
+      j.hash = res["result"].get<std::string>();
+      j.sentAt = std::chrono::steady_clock::now();
+      const std::unique_ptr<Account>& acc = this->wallet.getAccountDetails(j.req.from);
+      if (acc != nullptr) acc->nonceManager().markSent(j.nonce, j.hash);
+      if (this->opts.waitForReceipts) {
+        this->confirmQueue.push(std::move(j));
+      } else {
+        this->finish(j, 0);
+      }
+    }
+  }
+  this->confirmQueue.close();
+}
+
+void TxPipeline::confirmLoop() {
+  std::vector<Job> pending;
+  Job job;
+  while (true) {
+    // Only block for new jobs when there's nothing left to poll, and stop
+    // pulling once the pending list is full so backpressure reaches senders
+    if (pending.empty()) {
+      if (!this->confirmQueue.pop(job)) break;
+      pending.push_back(std::move(job));
+    }
+    while (pending.size() < this->opts.queueSize && this->confirmQueue.tryPop(job)) {
+      pending.push_back(std::move(job));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(this->opts.pollIntervalMs));
+
+    json requests = json::array();
+    for (const Job& j : pending) {
+      Error rpcErr;
+      requests.push_back(RPC::eth_getTransactionReceipt(j.hash, rpcErr));
+    }
+    json responses = this->eth.batchRequest(requests, this->opts.receiptBatchSize).get();
+
+    std::vector<Job> stillPending;
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < pending.size(); i++) {
+      Job& j = pending[i];
+      const json& res = responses[i];
+      if (res.contains("result") && res["result"].is_object()) {
+        const json& receipt = res["result"];
+        const std::unique_ptr<Account>& acc = this->wallet.getAccountDetails(j.req.from);
+        if (acc != nullptr) acc->nonceManager().markConfirmed(j.nonce);
+        bool reverted = (receipt.contains("status") && receipt["status"] == "0x0");
+        this->finish(j, (reverted) ? 38 : 0, receipt);  // Transaction Reverted
+      } else if (now - j.sentAt > std::chrono::seconds(this->opts.receiptTimeoutSec)) {
+        this->finish(j, 37);  // Transaction Receipt Timeout
+      } else {
+        stillPending.push_back(std::move(j));
+      }
+    }
+    pending.swap(stillPending);
+  }
+}
+
+void TxPipeline::finish(const Job& job, uint64_t errorCode, json receipt) {
+  Result r;
+  r.id = job.id;
+  r.from = job.req.from;
+  r.nonce = job.nonce;
+  r.hash = job.hash;
+  r.receipt = std::move(receipt);
+  r.errorCode = errorCode;
+  if (this->opts.onResult) this->opts.onResult(r);
+  std::lock_guard<std::mutex> lock(this->resultLock);
+  this->results[r.id] = std::move(r);
+}
+
+void TxPipeline::signJob(Job& job, Error &err) {
+  Error keyErr;
+  dev::Secret s = this->secretFor(job.req.from, keyErr);
+  if (keyErr.getCode() != 0) { err.setCode(keyErr.getCode()); return; }
+  try {
+    job.skel.nonce = job.nonce;
+    dev::eth::TransactionBase t(job.skel);
+    t.setNonce(job.skel.nonce);
+    t.sign(s);
+    job.signedTx = "0x" + dev::toHex(t.rlp());
+    job.hash = "0x" + t.sha3().hex();
+  } catch (std::exception &e) {
+    err.setCode(12); return;  // Transaction Sign Error
+  }
+  err.setCode(0);
+}
+
+bool TxPipeline::fillGap(Job& job) {
+  const std::unique_ptr<Account>& acc = this->wallet.getAccountDetails(job.req.from);
+  if (acc == nullptr) return false;
+  uint64_t nonce = acc->nonceManager().fillGap(job.nonce);
+  if (nonce == job.nonce) return false;
+  job.nonce = nonce;
+  job.skel.nonce = nonce;
+  return true;
+}
+
+dev::Secret TxPipeline::secretFor(const std::string& address, Error &err) {
+  std::shared_ptr<SecretEntry> entry;
+  {
+    std::lock_guard<std::mutex> lock(this->secretLock);
+    std::shared_ptr<SecretEntry>& cached = this->secrets[address];
+    if (cached == nullptr) cached = std::make_shared<SecretEntry>();
+    entry = cached;
+  }
+
+  // Decrypting is the expensive part of signing, so it's done once per account.
+  // Only signers of the same account wait for it.
+  std::lock_guard<std::mutex> lock(entry->lock);
+  if (!entry->loaded) {
+    Error decErr;
+    entry->secret = this->wallet.decryptSecret(address, this->password, decErr);
+    entry->errorCode = decErr.getCode();
+    entry->loaded = true;
+  }
+  if (entry->errorCode != 0) { err.setCode(entry->errorCode); return dev::Secret(); }
+  err.setCode(0);
+  return entry->secret;
+}
+
+void TxPipeline::releaseNonce(const Job& job) {
+  const std::unique_ptr<Account>& acc = this->wallet.getAccountDetails(job.req.from);
+  if (acc == nullptr) return;
+  acc->nonceManager().markFailed(job.nonce);
+}
+
+uint64_t TxPipeline::submit(Request req) {
+  req.from = Utils::toLowercaseAddress(req.from);
+  std::lock_guard<std::mutex> lock(this->submitLock);
+  Job job;
+  job.id = this->nextId;
+  job.req = std::move(req);
+  if (!this->buildQueue.push(std::move(job))) return UINT64_MAX;
+  return this->nextId++;
+}
+
+void TxPipeline::close() {
+  this->buildQueue.close();
+}
+
+std::vector<TxPipeline::Result> TxPipeline::wait() {
+  this->close();
+  bool justJoined = false;
+  {
+    std::lock_guard<std::mutex> lock(this->joinLock);
+    if (!this->joined) {
+      for (std::thread& t : this->workers) t.join();
+      this->joined = true;
+      justJoined = true;
+    }
+  }
+  if (justJoined) {
+    // Every worker is done, the decrypted keys aren't needed anymore
+    std::lock_guard<std::mutex> lock(this->secretLock);
+    this->secrets.clear();
+  }
+  std::vector<Result> ret;
+  std::lock_guard<std::mutex> lock(this->resultLock);
+  ret.reserve(this->results.size());
+  for (const std::pair<const uint64_t, Result>& r : this->results) ret.push_back(r.second);
+  return ret;
+}
@@ -0,0 +1,123 @@
+#include <web3cpp/TxRecord.h>
+
+namespace {
+  enum Flags : unsigned int { Confirmed = 1, Invalid = 2 };
+}
+
+TxRecord TxRecord::fromSignedTx(const std::string& signedTx) {
+  TxRecord ret;
+  ret.raw = dev::fromHex(signedTx);
+  ret.from = ret.tx().safeSender();
+  ret.unixDate = std::chrono::duration_cast<std::chrono::seconds>(
+    std::chrono::system_clock::now().time_since_epoch()
+  ).count();
+  return ret;
+}
+
+bool TxRecord::fromJson(const json& legacy, TxRecord& out) {
+  try {
+    out.raw = dev::fromHex(legacy.at("signature").get<std::string>());
+    std::string from = legacy.value("from", "<unsigned>");
+    out.from = (from == "<unsigned>") ? dev::Address() : dev::Address(from);
+    out.unixDate = legacy.value("unixDate", uint64_t(0));
+    out.blockNumber = legacy.value("blockNumber", uint64_t(0));
+    out.confirmed = legacy.value("confirmed", false);
+    out.invalid = legacy.value("invalid", false);
+  } catch (std::exception &e) {
+    return false;
+  }
+  return !out.raw.empty();
+}
+
+bool TxRecord::fromStored(std::string_view stored, TxRecord& out) {
+  if (TxRecord::isLegacy(stored)) {
+    json legacy = json::parse(stored, nullptr, false);
+    return !legacy.is_discarded() && TxRecord::fromJson(legacy, out);
+  }
+  try {
+    dev::RLP rlp(dev::bytesConstRef(
+      reinterpret_cast<const uint8_t*>(stored.data()), stored.size()
+    ));
+    // Newer versions may only append fields
+    if (!rlp.isList() || rlp.itemCount() < 6 || rlp[0].toInt<unsigned int>() < 1) return false;
+    unsigned int flags = rlp[1].toInt<unsigned int>();
+    dev::bytes from = rlp[2].toBytes();
+    out.from = (from.size() == 20) ? dev::Address(from) : dev::Address();
+    out.unixDate = rlp[3].toInt<uint64_t>();
+    out.blockNumber = rlp[4].toInt<uint64_t>();
+    out.raw = rlp[5].toBytes();
+    out.confirmed = (flags & Confirmed);
+    out.invalid = (flags & Invalid);
+  } catch (std::exception &e) {
+    return false;
+  }
+  return true;
+}
+
+std::string TxRecord::encode() const {
+  dev::RLPStream s(6);
+  s << TxRecord::version
+    << ((this->confirmed ? Confirmed : 0u) | (this->invalid ? Invalid : 0u));
+  if (this->from) s << this->from; else s << dev::bytes();
+  s << this->unixDate << this->blockNumber << this->raw;
+  const dev::bytes& out = s.out();
+  return std::string(out.begin(), out.end());
+}
+
+dev::eth::TransactionBase TxRecord::tx() const {
+  return dev::eth::TransactionBase(this->raw, dev::eth::CheckTransaction::None);
+}
+
+std::string TxRecord::key() const {
+  return this->tx().sha3(dev::eth::WithoutSignature).hex();
+}
+
+json TxRecord::toJson() const {
+  json ret;
+  dev::eth::TransactionBase tx = this->tx();
+
+  // Creation, message, sender, receiver and data
+  ret["hex"] = tx.sha3().hex();
+  if (tx.isCreation()) {
+    ret["type"] = "creation";
+    ret["code"] = dev::toHex(tx.data());
+  } else {
+    ret["type"] = "message";
+    ret["to"] = boost::lexical_cast<std::string>(tx.to());
+    ret["data"] = (tx.data().empty() ? "" : dev::toHex(tx.data()));
+  }
+  if (this->from) {
+    if (tx.isCreation()) {
+      ret["creates"] = boost::lexical_cast<std::string>(dev::toAddress(this->from, tx.nonce()));
+    }
+    ret["from"] = boost::lexical_cast<std::string>(this->from);
+  } else {
+    ret["from"] = "<unsigned>";
+  }
+
+  // Value, nonce, gas limit, gas price, hash and r/s/v signature keys
+  ret["value"] = Utils::fromWei(boost::lexical_cast<std::string>(tx.value()), 18) + " AVAX";
+  ret["nonce"] = boost::lexical_cast<std::string>(tx.nonce());
+  ret["gas"] = boost::lexical_cast<std::string>(tx.gas());
+  ret["price"] = dev::eth::formatBalance(tx.gasPrice()) + " (" +
+    boost::lexical_cast<std::string>(tx.gasPrice()) + " wei)";
+  ret["hash"] = tx.sha3(dev::eth::WithoutSignature).hex();
+  if (this->from) {
+    ret["r"] = boost::lexical_cast<std::string>(tx.signature().r);
+    ret["s"] = boost::lexical_cast<std::string>(tx.signature().s);
+    ret["v"] = boost::lexical_cast<std::string>(tx.signature().v);
+  }
+
+  // Timestamps (epoch and human-readable), block and status
+  std::time_t t = static_cast<std::time_t>(this->unixDate);
+  std::tm tm = *std::localtime(&t);
+  std::stringstream timestream;
+  timestream << std::put_time(&tm, "%d-%m-%Y %H-%M-%S");
+  ret["humanDate"] = timestream.str();
+  ret["confirmed"] = this->confirmed;
+  ret["unixDate"] = this->unixDate;
+  ret["invalid"] = this->invalid;
+  if (this->blockNumber > 0) ret["blockNumber"] = this->blockNumber;
+  ret["signature"] = dev::toHex(this->raw);
+  return ret;
+}
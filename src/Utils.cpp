@@ -78,14 +78,13 @@ std::string Utils::soliditySha3Raw(json params, Error &err) {
 }
 
 bool Utils::isHex(const std::string& hex) {
-  if (hex.substr(0, 2) == "0x" || hex.substr(0, 2) == "0X") { 
-    return (hex.substr(2).find_first_not_of("0123456789abcdefABCDEF") == std::string::npos); 
-  }
-  return (hex.find_first_not_of("0123456789abcdefABCDEF") == std::string::npos);
+  // Skip the prefix in place instead of copying the string, logs and ABI data can be big
+  size_t start = (hex.size() >= 2 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) ? 2 : 0;
+  return (hex.find_first_not_of("0123456789abcdefABCDEF", start) == std::string::npos);
 }
 
 bool Utils::isHexStrict(const std::string& hex) {
-  return (hex.substr(0, 2) == "0x" || hex.substr(0, 2) == "0X") ? isHex(hex) : false;
+  return (hex.size() >= 2 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) ? isHex(hex) : false;
 }
 
 bool Utils::isNumber(const std::string& str) {
@@ -93,18 +92,21 @@ bool Utils::isNumber(const std::string& str) {
 }
 
 bool Utils::isAddress(const std::string& address) {
-  // Regexes for checking the basic requirements of an address,
-  // all lower or all upper case, respectively.
-  std::regex addRegex = std::regex("^(0x|0X)?[0-9a-fA-F]{40}$");
-  std::regex lowRegex = std::regex("^(0x|0X)?[0-9a-f]{40}$");
-  std::regex uppRegex = std::regex("^(0x|0X)?[0-9A-F]{40}$");
-  if (!std::regex_match(address, addRegex)) {
-    return false;
-  } else if (std::regex_match(address, lowRegex) || std::regex_match(address, uppRegex)) {
-    return true;
-  } else {
-    return checkAddressChecksum(address);
+  // Check the basic requirements of an address in a single pass
+  // (as it's checked for every address that gets ABI-encoded),
+  // then the checksum only if it's in mixed case.
+  size_t start = (
+    address.size() >= 2 && address[0] == '0' && (address[1] == 'x' || address[1] == 'X')
+  ) ? 2 : 0;
+  if (address.size() - start != 40) return false;
+  bool hasLower = false, hasUpper = false;
+  for (size_t i = start; i < address.size(); i++) {
+    char c = address[i];
+    if (c >= 'a' && c <= 'f') hasLower = true;
+    else if (c >= 'A' && c <= 'F') hasUpper = true;
+    else if (c < '0' || c > '9') return false;
   }
+  return (hasLower && hasUpper) ? checkAddressChecksum(address) : true;
 }
 
 std::string Utils::toLowercaseAddress(const std::string& address) {
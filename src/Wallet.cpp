@@ -1,10 +1,97 @@
 #include <web3cpp/Wallet.h>
 
+namespace {
+  /**
+   * Run a function for every index in [0, count) over a pool of threads.
+   * Indexes are handed out one by one, so uneven work is balanced.
+   * @param count The number of indexes.
+   * @param threads The number of threads. 0 means one per CPU core.
+   * @param f The function, called as `f(index, workerId)`.
+   */
+  template <typename F> void parallelFor(uint64_t count, unsigned int threads, F f) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned int>(std::min<uint64_t>(threads, count));
+    std::atomic<uint64_t> next(0);
+    std::vector<std::thread> pool;
+    for (unsigned int w = 0; w < threads; w++) {
+      pool.emplace_back([&, w]{
+        for (uint64_t i = next++; i < count; i = next++) f(i, w);
+      });
+    }
+    for (std::thread& t : pool) t.join();
+  }
+}
+
+dev::Address Wallet::accountKey(const std::string& address) {
+  try {
+    return dev::eth::toAddress(address);
+  } catch (std::exception &e) {
+    return dev::Address();
+  }
+}
+
+void Wallet::migrateLegacyStorage() {
+  auto migrate = [](const boost::filesystem::path& folder, const std::string& name, Database& target) {
+    if (!boost::filesystem::exists(folder / name / "CURRENT")) return;
+    {
+      Database legacy(name, folder);
+      if (!legacy.isOpen()) return;
+      Database::Batch copy = target.batch();
+      for (std::pair<std::string, std::string> item : legacy.getAllPairs()) {
+        copy.put(item.first, item.second);
+      }
+      // Synced, as the legacy folder is removed right after
+      if (!copy.commit(true)) return;
+    }
+    boost::filesystem::remove_all(folder / name);
+  };
+  migrate(walletFolder(), "walletInfo", this->infoDB);
+  migrate(walletFolder(), "accounts", this->accountDB);
+  if (boost::filesystem::is_directory(transactionsFolder())) {
+    for (const boost::filesystem::directory_entry& entry :
+      boost::filesystem::directory_iterator(transactionsFolder())
+    ) {
+      std::string address = entry.path().filename().string();
+      Database history = this->historyDB(address);
+      migrate(transactionsFolder(), address, history);
+    }
+    if (boost::filesystem::is_empty(transactionsFolder())) {
+      boost::filesystem::remove(transactionsFolder());
+    }
+  }
+  convertLegacyHistory();
+}
+
+void Wallet::convertLegacyHistory() {
+  // 1: TxRecords, 2: TxRecords with TxIndex entries
+  const std::string format = "2";
+  if (this->infoDB.getKeyValue("historyFormat") == format) return;
+  Database histories = this->walletDB.partition("tx/");
+  Database::Batch convert = histories.batch();
+  // Reads come from a snapshot, so the batches don't disturb the scan
+  for (Database::Cursor c = histories.snapshot().cursor(); c.valid(); c.next()) {
+    // Keys are "<address>/<hash>", skip internal ones (e.g. "<address>/_nonceState")
+    std::string_view key = c.key();
+    size_t slash = key.find('/');
+    if (slash == std::string_view::npos || key.substr(slash + 1, 1) == "_") continue;
+    TxRecord record;
+    if (!TxRecord::fromStored(c.value(), record)) continue;
+    std::string address(key.substr(0, slash));
+    TxIndex index(this->historyDB(address), dev::Address(address));
+    try {
+      index.add(convert, record);
+    } catch (std::exception &e) {
+      continue;  // Undecodable transaction, left as it is
+    }
+    if (convert.size() >= 1024 && !convert.commit()) return;
+  }
+  if (!convert.commit(true)) return;
+  this->infoDB.putKeyValue("historyFormat", format);
+}
+
 bool Wallet::createNewWallet(std::string const &password, Error &error) {
   // Create the paths if they don't exist yet
-  std::vector<boost::filesystem::path> paths {
-    walletExistsPath(), walletFolder(), accountsFolder(), transactionsFolder()
-  };
+  std::vector<boost::filesystem::path> paths { walletExistsPath(), walletFolder() };
   for (boost::filesystem::path path : paths) {
     if (!boost::filesystem::exists(path)) {
       boost::filesystem::create_directories(path);
@@ -64,14 +151,15 @@ bool Wallet::loadWallet(const std::string& password, Error &error) {
     // If wallet already exists, populate this->accountList from DB.
     for (auto const& acc : this->accountDB.getAllPairs()) {
       json accJson = json::parse(acc.second);
-      this->accountList.emplace_back(std::make_unique<Account>(
-        boost::filesystem::path(this->path.string() + "/wallet"),
+      auto added = this->accountList.emplace(accountKey(acc.first), std::make_unique<Account>(
+        this->historyDB(accJson["address"].get<std::string>()),
         accJson["address"].get<std::string>(),
         accJson["name"].get<std::string>(),
         accJson["derivationPath"].get<std::string>(),
         accJson["isLedger"].get<bool>(),
         this->provider
       ));
+      added.first->second->setHistoryWriter(this->historyWriter);
     }
   }
 
@@ -172,45 +260,34 @@ bool Wallet::importPrivKey(
   encryptedKey["isLedger"] = false;
 
   // Import the account
-  for (auto const &acc : this->accountList) {
-    if (encryptedKey["address"] == acc->address()) {
-      error.setCode(3);  // Account Exists
-      return false;
-    }
+  dev::Address accKey = dev::toAddress(secret);
+  if (this->accountList.count(accKey)) {
+    error.setCode(3);  // Account Exists
+    return false;
   }
   if (!accountDB.putKeyValue(encryptedKey["address"], encryptedKey.dump())) {
     error.setCode(2); // Database Insert Failed
     return false;
   }
 
-  // Import to vector
-  this->accountList.emplace_back(std::make_unique<Account>(
-    boost::filesystem::path(this->path.string() + "/wallet"),
+  // Import to the account list
+  auto added = this->accountList.emplace(accKey, std::make_unique<Account>(
+    this->historyDB(encryptedKey["address"].get<std::string>()),
     encryptedKey["address"].get<std::string>(),
     encryptedKey["name"].get<std::string>(),
     encryptedKey["derivationPath"].get<std::string>(),
     encryptedKey["isLedger"].get<bool>(),
     this->provider
   ));
+  added.first->second->setHistoryWriter(this->historyWriter);
   error.setCode(0); // No Error
   return true;
 }
 
 bool Wallet::deleteAccount(std::string address) {
-  // Delete from vector
+  // Delete from the account list
   address = Utils::toLowercaseAddress(address);
-  bool accFound = false;
-  uint64_t accIndex = 0;
-  for (uint64_t i = 0; i < this->accountList.size(); ++i) {
-    if (accountList[i]->address() == address) {
-      accIndex = i;
-      accFound = true;
-    }
-  }
-  if (accFound) {
-    this->accountList.erase(accountList.begin() + accIndex);
-    this->accountList.shrink_to_fit();
-  }
+  this->accountList.erase(accountKey(address));
 
   // Delete from DB Permanently.
   return this->accountDB.deleteKeyValue(address);
@@ -221,11 +298,9 @@ std::string Wallet::sign(
 ) {
   // EIP-712 requires us to hash the message before signing
   address = Utils::toLowercaseAddress(address);
-  json accRaw = getAccountRawDetails(address);
   Error decErr;
-  std::string dec = Cipher::decrypt(accRaw.dump(), password, decErr);
+  Secret s = this->decryptSecret(address, password, decErr);
   if (decErr.getCode() != 0) return decErr.what();
-  Secret s(dev::toHex(dec));
   std::string signableData = std::string("\x19") + "Ethereum Signed Message:\n"
     + boost::lexical_cast<std::string>(dataToSign.size()) + dataToSign;
   dev::h256 messageHash(dev::toHex(dev::sha3(signableData, false)));
@@ -252,7 +327,7 @@ std::string Wallet::ecRecover(
 dev::eth::TransactionSkeleton Wallet::buildTransaction(
   std::string from, std::string to,
   BigNumber value, BigNumber gasLimit, BigNumber gasPrice,
-  std::string dataHex, int nonce, Error &error, bool creation
+  std::string dataHex, uint64_t nonce, Error &error, bool creation
 ) {
   dev::eth::TransactionSkeleton ret;
   try {
@@ -273,14 +348,113 @@ dev::eth::TransactionSkeleton Wallet::buildTransaction(
   return ret;
 }
 
+dev::eth::TransactionSkeleton Wallet::buildTransaction(
+  std::string from, std::string to,
+  BigNumber value, BigNumber gasLimit, BigNumber gasPrice,
+  std::string dataHex, Error &error, bool creation
+) {
+  const std::unique_ptr<Account>& acc = this->getAccountDetails(from);
+  if (acc == nullptr) {
+    error.setCode(11);  // Transaction Build Error
+    return dev::eth::TransactionSkeleton();
+  }
+  Error nonceErr;
+  uint64_t nonce = acc->nonceManager().next(nonceErr);
+  if (nonceErr.getCode() != 0) {
+    error.setCode(nonceErr.getCode());
+    return dev::eth::TransactionSkeleton();
+  }
+  dev::eth::TransactionSkeleton ret = this->buildTransaction(
+    from, to, value, gasLimit, gasPrice, dataHex, nonce, error, creation
+  );
+  if (error.getCode() != 0) acc->nonceManager().markFailed(nonce);
+  return ret;
+}
+
+
+dev::SecureFixedHash<32> Wallet::sessionHash(const std::string& password) const {
+  dev::bytesSec preimage(this->sessionSalt.size + password.size());
+  dev::bytes& buf = preimage.writable();
+  std::copy(this->sessionSalt.begin(), this->sessionSalt.end(), buf.begin());
+  std::copy(password.begin(), password.end(), buf.begin() + this->sessionSalt.size);
+  return dev::sha3Secure(preimage.ref());
+}
+
+dev::Secret Wallet::decryptSecret(
+  const std::string& address, const std::string& password, Error &err
+) {
+  dev::Address key = accountKey(address);
+  bool sessionUnlocked = false;
+  TimerService::TimerId stale = 0;
+  {
+    std::lock_guard<std::mutex> lock(this->sessionLock);
+    if (this->sessionTTL > 0 && this->sessionHash(password) == this->sessionPassHash) {
+      sessionUnlocked = true;
+      auto it = this->sessionKeys.find(key);
+      if (it != this->sessionKeys.end()) {
+        if (it->second.expiry > std::chrono::steady_clock::now()) {
+          this->sessionHits++;
+          err.setCode(0);
+          return it->second.secret;
+        }
+        // Expired, but its timer didn't get to it yet
+        stale = it->second.timer;
+        this->sessionKeys.erase(it);
+      }
+      this->sessionMisses++;
+    }
+  }
+  TimerService::instance().cancel(stale);
+
+  Error decErr;
+  std::string dec = Cipher::decrypt(
+    getAccountRawDetails(address).dump(), password, decErr
+  );
+  if (decErr.getCode() != 0) { err.setCode(decErr.getCode()); return dev::Secret(); }
+  dev::Secret ret(dev::toHex(dec));
+  if (sessionUnlocked) {
+    {
+      std::lock_guard<std::mutex> lock(this->sessionLock);
+      if (this->sessionTTL > 0) {
+        SessionKey& entry = this->sessionKeys[key];
+        stale = entry.timer;
+        uint64_t gen = ++this->sessionGen;
+        entry.secret = ret;
+        entry.expiry = std::chrono::steady_clock::now() + std::chrono::seconds(this->sessionTTL);
+        entry.gen = gen;
+        entry.timer = TimerService::instance().schedule(
+          std::chrono::seconds(this->sessionTTL), [this, key, gen]{ this->evictSessionKey(key, gen); }
+        );
+      }
+    }
+    TimerService::instance().cancel(stale);
+  }
+  err.setCode(0);
+  return ret;
+}
+
+void Wallet::evictSessionKey(const dev::Address& key, uint64_t gen) {
+  std::lock_guard<std::mutex> lock(this->sessionLock);
+  auto it = this->sessionKeys.find(key);
+  if (it != this->sessionKeys.end() && it->second.gen == gen) this->sessionKeys.erase(it);
+}
+
+void Wallet::clearSessionKeys(std::unique_lock<std::mutex>& lock) {
+  std::vector<TimerService::TimerId> timers;
+  timers.reserve(this->sessionKeys.size());
+  for (const std::pair<const dev::Address, SessionKey>& entry : this->sessionKeys) {
+    timers.push_back(entry.second.timer);
+  }
+  this->sessionKeys.clear();
+  lock.unlock();
+  for (TimerService::TimerId timer : timers) TimerService::instance().cancel(timer);
+}
 
 std::string Wallet::signTransaction(
   dev::eth::TransactionSkeleton txObj, std::string password, Error &err
 ) {
   Error e;
-  Secret s(dev::toHex(Cipher::decrypt(
-    getAccountRawDetails("0x" + dev::toString(txObj.from)).dump(), password, e
-  )));
+  Secret s = this->decryptSecret("0x" + dev::toString(txObj.from), password, e);
   if (e.getCode() != 0) { err.setCode(e.getCode()); return ""; }
   try {
     std::stringstream txHexBuffer;
@@ -295,6 +469,89 @@ std::string Wallet::signTransaction(
   }
 }
 
+std::unordered_map<dev::Address, dev::Secret> Wallet::decryptSecrets(
+  const std::vector<std::string>& addresses, const std::string& password,
+  unsigned int threads
+) {
+  std::vector<std::string> distinct;
+  std::unordered_set<dev::Address> seen;
+  for (const std::string& address : addresses) {
+    if (seen.insert(accountKey(address)).second) distinct.push_back(address);
+  }
+
+  // Key derivation dominates here, so distinct keys are decrypted in parallel too
+  std::vector<dev::Secret> secrets(distinct.size());
+  std::vector<char> ok(distinct.size(), 0);  // Not vector<bool>, workers write it concurrently
+  parallelFor(distinct.size(), threads, [&](uint64_t i, unsigned int){
+    Error decErr;
+    secrets[i] = this->decryptSecret(distinct[i], password, decErr);
+    if (decErr.getCode() == 0) ok[i] = 1;
+  });
+  std::unordered_map<dev::Address, dev::Secret> ret;
+  for (uint64_t i = 0; i < distinct.size(); i++) {
+    if (ok[i]) ret.emplace(accountKey(distinct[i]), secrets[i]);
+  }
+  return ret;
+}
+
+std::vector<std::string> Wallet::signTransactions(
+  const std::vector<dev::eth::TransactionSkeleton>& txObjs,
+  const std::string& password, Error &err, unsigned int threads
+) {
+  std::vector<std::string> ret(txObjs.size());
+  std::vector<std::string> addresses;
+  addresses.reserve(txObjs.size());
+  for (const dev::eth::TransactionSkeleton& tx : txObjs) {
+    addresses.push_back("0x" + dev::toString(tx.from));
+  }
+  std::unordered_map<dev::Address, dev::Secret> keys = this->decryptSecrets(addresses, password, threads);
+
+  // One RLP stream per worker, reused so its buffer only grows once
+  if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+  std::vector<dev::RLPStream> streams(threads);
+  std::atomic<uint64_t> firstError(0);
+  parallelFor(txObjs.size(), threads, [&](uint64_t i, unsigned int w){
+    auto key = keys.find(txObjs[i].from);
+    if (key == keys.end()) { uint64_t none = 0; firstError.compare_exchange_strong(none, 16); return; } // Key Decryption Failed
+    try {
+      dev::eth::TransactionBase t(txObjs[i]);
+      t.setNonce(txObjs[i].nonce);
+      t.sign(key->second);
+      streams[w].clear();
+      t.streamRLP(streams[w]);
+      ret[i] = dev::toHex(streams[w].out());
+    } catch (std::exception &e) {
+      uint64_t none = 0; firstError.compare_exchange_strong(none, 12); // Transaction Sign Error
+    }
+  });
+  err.setCode(firstError);
+  return ret;
+}
+
+std::vector<std::string> Wallet::signMessages(
+  const std::vector<std::pair<std::string, std::string>>& messages,
+  const std::string& password, Error &err, unsigned int threads
+) {
+  std::vector<std::string> ret(messages.size());
+  std::vector<std::string> addresses;
+  addresses.reserve(messages.size());
+  for (const std::pair<std::string, std::string>& msg : messages) addresses.push_back(msg.first);
+  std::unordered_map<dev::Address, dev::Secret> keys = this->decryptSecrets(addresses, password, threads);
+
+  std::atomic<uint64_t> firstError(0);
+  parallelFor(messages.size(), threads, [&](uint64_t i, unsigned int){
+    auto key = keys.find(accountKey(messages[i].first));
+    if (key == keys.end()) { uint64_t none = 0; firstError.compare_exchange_strong(none, 16); return; } // Key Decryption Failed
+    const std::string& data = messages[i].second;
+    std::string signableData = std::string("\x19") + "Ethereum Signed Message:\n"
+      + boost::lexical_cast<std::string>(data.size()) + data;
+    dev::h520 signature = dev::sign(key->second, dev::sha3(signableData));
+    ret[i] = std::string("0x") + dev::toHex(signature);
+  });
+  err.setCode(firstError);
+  return ret;
+}
+
 std::future<json> Wallet::sendTransaction(std::string signedTx, Error &err) {
   if (signedTx.substr(0,2) != "0x" && signedTx.substr(0,2) != "0X") {
     signedTx.insert(0, "0x");
@@ -322,57 +579,184 @@ std::future<json> Wallet::sendTransaction(std::string signedTx, Error &err) {
       txResult["result"] = reqJson["result"].get<std::string>();
       err.setCode(0);
     }
+
+    // Update the sender's nonce tracker, if the sender belongs to this wallet
+    try {
+      dev::eth::TransactionBase tx(
+        dev::fromHex(signedTx), dev::eth::CheckTransaction::None
+      );
+      const std::unique_ptr<Account>& acc = this->getAccountDetails(
+        "0x" + dev::toHex(tx.safeSender())
+      );
+      if (acc != nullptr) {
+        uint64_t nonce = uint64_t(tx.nonce());
+        if (txResult.count("result")) {
+          acc->nonceManager().markSent(nonce, txResult["result"].get<std::string>());
+        } else {
+          acc->nonceManager().markFailed(nonce);
+        }
+      }
+    } catch (std::exception &e) {}
     return txResult;
   });
 }
 
+Wallet::~Wallet() {
+  this->cancelPassTimer();
+  this->lockSession();
+}
+
+void Wallet::cancelPassTimer() {
+  // Cancelling waits for a running timer, which takes passLock itself,
+  // so the lock is released before cancelling
+  TimerService::TimerId timer;
+  {
+    std::lock_guard<std::mutex> lock(this->passLock);
+    timer = this->_passTimer;
+    this->_passTimer = 0;
+    this->_passGen++;
+  }
+  TimerService::instance().cancel(timer);
+}
+
 void Wallet::storePassword(const std::string& password, unsigned int seconds) {
-  this->_password = password;
-  if (seconds > 0) {
-    this->_passEnd = std::time(nullptr) + seconds;
-    this->_passThread = std::thread(std::bind(&Wallet::passHandler, this));
-    this->_passThread.detach();
+  TimerService::TimerId stale;
+  {
+    std::lock_guard<std::mutex> lock(this->passLock);
+    stale = this->_passTimer;
+    this->_passTimer = 0;
+    this->_password = password;
+    this->_passEnd = 0;
+    uint64_t gen = ++this->_passGen;
+    if (seconds > 0) {
+      this->_passEnd = std::time(nullptr) + seconds;
+      this->_passTimer = TimerService::instance().schedule(std::chrono::seconds(seconds), [this, gen]{
+        std::lock_guard<std::mutex> lock(this->passLock);
+        if (this->_passGen != gen) return; // Password was stored again or cleared meanwhile
+        this->_password.clear();
+        this->_passEnd = 0;
+        this->_passTimer = 0;
+      });
+    }
   }
+  TimerService::instance().cancel(stale);
 }
 
 void Wallet::clearPassword() {
-  this->_password = "";
-  this->_passEnd = 0; // This ensures the thread will be terminated
+  this->cancelPassTimer();
+  {
+    std::lock_guard<std::mutex> lock(this->passLock);
+    this->_password.clear();
+    this->_passEnd = 0;
+  }
+  this->lockSession();
+}
+
+bool Wallet::unlockSession(const std::string& password, unsigned int ttlSeconds, Error &err) {
+  if (!this->checkPassword(password)) { err.setCode(1); return false; } // Incorrect Password
+  std::unique_lock<std::mutex> lock(this->sessionLock);
+  this->sessionSalt = dev::h256::random();
+  this->sessionPassHash = this->sessionHash(password);
+  this->sessionTTL = ttlSeconds;
+  this->sessionHits = 0;
+  this->sessionMisses = 0;
+  this->clearSessionKeys(lock);
+  err.setCode(0);
+  return true;
+}
+
+void Wallet::lockSession() {
+  std::unique_lock<std::mutex> lock(this->sessionLock);
+  this->sessionPassHash = dev::SecureFixedHash<32>();
+  this->sessionTTL = 0;
+  this->clearSessionKeys(lock);
+}
+
+bool Wallet::isSessionUnlocked() const {
+  std::lock_guard<std::mutex> lock(this->sessionLock);
+  return this->sessionTTL > 0;
+}
+
+std::size_t Wallet::sessionKeyCount() const {
+  std::lock_guard<std::mutex> lock(this->sessionLock);
+  return this->sessionKeys.size();
+}
+
+std::pair<uint64_t, uint64_t> Wallet::sessionStats() const {
+  std::lock_guard<std::mutex> lock(this->sessionLock);
+  return std::make_pair(this->sessionHits, this->sessionMisses);
 }
 
 bool Wallet::isPasswordStored() {
+  std::lock_guard<std::mutex> lock(this->passLock);
   return !this->_password.empty();
 }
 
+std::future<bool> Wallet::refreshNonces(Error &err, unsigned int batchSize) {
+  std::vector<std::string> addresses = this->getAccounts();
+  return std::async([this, addresses, batchSize, &err]{
+    json requests = json::array();
+    for (const std::string& address : addresses) {
+      Error rpcErr;
+      requests.push_back(RPC::eth_getTransactionCount(address, "pending", rpcErr));
+    }
+    Eth eth(this->provider);
+    json responses = eth.batchRequest(requests, batchSize).get();
+    bool allSynced = true;
+    for (uint64_t i = 0; i < addresses.size(); i++) {
+      const json& res = responses[i];
+      const std::unique_ptr<Account>& acc = this->getAccountDetails(addresses[i]);
+      if (acc == nullptr) continue;
+      if (!res.contains("result") || !res["result"].is_string()) {
+        allSynced = false; continue;
+      }
+      const std::string& count = res["result"].get_ref<const std::string&>();
+      if (count.size() <= 2 || count.size() > 18 || !Utils::isHexStrict(count)) {
+        allSynced = false; continue;
+      }
+      acc->nonceManager().sync(boost::lexical_cast<HexTo<uint64_t>>(count));
+    }
+    err.setCode((allSynced) ? 0 : 36); // RPC Batch Request Failed
+    return allSynced;
+  });
+}
+
+void Wallet::setHistoryWriteBehind(bool enable) {
+  if (enable == (this->historyWriter != nullptr)) return;
+  std::shared_ptr<HistoryWriter> old = this->historyWriter;
+  if (enable) this->historyWriter = std::make_shared<HistoryWriter>(this->walletDB);
+  else this->historyWriter.reset();
+  for (auto const &acc : this->accountList) {
+    acc.second->setHistoryWriter(this->historyWriter);
+  }
+  // Accounts are detached first, so nothing can be queued after the flush
+  if (old) old->flush();
+}
+
+bool Wallet::flushHistory() {
+  return (this->historyWriter) ? this->historyWriter->flush() : true;
+}
+
 std::vector<std::string> Wallet::getAccounts() {
   std::vector<std::string> ret;
+  ret.reserve(this->accountList.size());
   for (auto const &acc : this->accountList) {
-    ret.push_back(acc->address());
+    ret.push_back(acc.second->address());
   }
+  std::sort(ret.begin(), ret.end());
   return ret;
 }
 
 const std::unique_ptr<Account>& Wallet::getAccountDetails(std::string address) {
-  address = Utils::toLowercaseAddress(address);
-  for (auto &acc : this->accountList) {
-    if (acc->address() == address) {
-      return acc;
-    }
-  }
-
-  return NullAccount;
+  auto it = this->accountList.find(accountKey(address));
+  return (it != this->accountList.end()) ? it->second : NullAccount;
 }
 
 json Wallet::getAccountRawDetails(std::string address) {
   json ret;
   address = Utils::toLowercaseAddress(address);
-  std::map<std::string, std::string> accs = this->accountDB.getAllPairs();
-  for (std::pair<std::string, std::string> acc : accs) {
-    if (acc.first == address) {
-      ret = json::parse(acc.second);
-      break;
-    }
-  }
+  std::string acc = this->accountDB.getKeyValue(address);
+  if (!acc.empty()) ret = json::parse(acc);
   return ret;
 }
 
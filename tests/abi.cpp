@@ -0,0 +1,685 @@
+#include "../src/libs/catch2/catch_amalgamated.hpp"
+#include "../include/web3cpp/ABI.h"
+#include "../include/web3cpp/Contract.h"
+#include "../include/web3cpp/Solidity.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace TABI
+{
+    std::string word(const std::string& hex) { return Utils::padLeft(hex, 64); }
+
+    TEST_CASE("Test ABI Encoder")
+    {
+        SECTION("Parse Uint")
+        {
+            REQUIRE(ABI::parseUint("") == 0);
+            REQUIRE(ABI::parseUint("0") == 0);
+            REQUIRE(ABI::parseUint("129831751235123") == BigNumber("129831751235123"));
+            std::string max = "115792089237316195423570985008687907853269984665640564039457584007913129639935";
+            REQUIRE(ABI::parseUint(max) == BigNumber(max));
+        }
+
+        SECTION("Static Types")
+        {
+            dev::bytes selector = ABI::selector("f(uint256,address,bool)");
+            ABI::Encoder enc(3, &selector);
+            enc.addUint(BigNumber("0x7614cf69b633"));
+            enc.addAddress(dev::Address("0xc4ea73d428ab6589c36905d0f0b01f3051740ff8"));
+            enc.addBool(true);
+            REQUIRE(enc.complete());
+            REQUIRE(enc.data().size() == 4 + 96);
+            REQUIRE(enc.hex() == "0x" + Solidity::packFunction("f(uint256,address,bool)") +
+                word("7614cf69b633") + word("c4ea73d428ab6589c36905d0f0b01f3051740ff8") + word("1"));
+        }
+
+        SECTION("Offsets After Static Arrays")
+        {
+            // f(uint256[],string) with two numbers: the string starts after 3 words of array
+            ABI::Encoder enc(2);
+            enc.addUintArray({1, 2});
+            enc.addString("abc");
+            REQUIRE(enc.hex() == "0x" + word("40") + word("a0") + word("2") + word("1") + word("2") +
+                word("3") + Utils::padRight("616263", 64));
+        }
+
+        SECTION("Empty Dynamic Values")
+        {
+            ABI::Encoder enc(2);
+            enc.addBytes(dev::bytesConstRef());
+            enc.addStringArray({});
+            REQUIRE(enc.hex() == "0x" + word("40") + word("60") + word("0") + word("0"));
+        }
+
+        SECTION("Typed And JSON Values Match")
+        {
+            json args = {
+                {{"t", "uint256"}, {"v", "129831751235123"}},
+                {{"t", "address"}, {"v", "0xc4ea73d428ab6589c36905d0f0b01f3051740ff8"}},
+                {{"t", "bool"}, {"v", "false"}},
+                {{"t", "bytes"}, {"v", "0xaaa"}},
+                {{"t", "string"}, {"v", "Hello!%"}},
+                {{"t", "uint256[]"}, {"v", {"1", "2", "3", "4"}}},
+                {{"t", "address[]"}, {"v", {"0xc4ea73d428ab6589c36905d0f0b01f3051740ff8"}}},
+                {{"t", "bool[]"}, {"v", {"true", "0"}}},
+                {{"t", "bytes[]"}, {"v", {"0xaaaa", "bbbbbb"}}},
+                {{"t", "string[]"}, {"v", {"aaa", ""}}}
+            };
+            Error err;
+            std::string packed = Solidity::packMulti(args, err);
+            REQUIRE(err.getCode() == 0);
+
+            dev::bytes buffer;
+            ABI::Encoder enc(buffer, args.size());
+            enc.addUint(129831751235123);
+            enc.addAddress(dev::Address("0xc4ea73d428ab6589c36905d0f0b01f3051740ff8"));
+            enc.addBool(false);
+            dev::bytes data = dev::fromHex("0x0aaa");
+            enc.addBytes(&data);
+            enc.addString("Hello!%");
+            enc.addUintArray({1, 2, 3, 4});
+            enc.addAddressArray({dev::Address("0xc4ea73d428ab6589c36905d0f0b01f3051740ff8")});
+            enc.addBoolArray({true, false});
+            enc.addBytesArray({dev::fromHex("aaaa"), dev::fromHex("bbbbbb")});
+            enc.addStringArray({"aaa", ""});
+            REQUIRE(enc.complete());
+            REQUIRE(enc.hex() == packed);
+            REQUIRE(dev::toHexPrefixed(buffer) == packed);
+        }
+
+        SECTION("Reused Buffer")
+        {
+            dev::bytes buffer;
+            {
+                ABI::Encoder enc(buffer, 1);
+                enc.addString(std::string(100, 'a'));
+            }
+            size_t capacity = buffer.capacity();
+            ABI::Encoder enc(buffer, 1);
+            enc.addUint(5);
+            REQUIRE(buffer.size() == 32);
+            REQUIRE(buffer.capacity() == capacity);
+            REQUIRE(enc.hex() == "0x" + word("5"));
+        }
+
+        SECTION("Missing Arguments")
+        {
+            ABI::Encoder enc(2);
+            enc.addBool(true);
+            REQUIRE(!enc.complete());
+        }
+    }
+
+    TEST_CASE("Test ABI Decoder")
+    {
+        SECTION("Parse Types")
+        {
+            ABI::Type t;
+            REQUIRE(ABI::Type::parse("uint", json::array(), t));
+            REQUIRE(t.canonical() == "uint256");
+            REQUIRE(ABI::Type::parse("int8", json::array(), t));
+            REQUIRE((t.kind == ABI::Type::Int && t.size == 8));
+            REQUIRE(ABI::Type::parse("bytes32[2][]", json::array(), t));
+            REQUIRE((t.kind == ABI::Type::Array && t.length == 0 && t.isDynamic()));
+            REQUIRE((t.components[0].length == 2 && t.components[0].headSize() == 64));
+            REQUIRE(t.canonical() == "bytes32[2][]");
+            json components = {{{"name", "a"}, {"type", "uint256"}}, {{"name", "b"}, {"type", "string"}}};
+            REQUIRE(ABI::Type::parse("tuple[]", components, t));
+            REQUIRE(t.canonical() == "(uint256,string)[]");
+            REQUIRE(!ABI::Type::parse("uint7", json::array(), t));
+            REQUIRE(!ABI::Type::parse("bytes33", json::array(), t));
+            REQUIRE(!ABI::Type::parse("fixed128x18", json::array(), t));
+            REQUIRE(!ABI::Type::parse("[2]", json::array(), t));
+
+            REQUIRE(ABI::Type::parse("function", json::array(), t));
+            REQUIRE((t.kind == ABI::Type::Function && t.headSize() == 32));
+            REQUIRE(t.canonical() == "function");
+            REQUIRE(ABI::Type::parse("bytes24", json::array(), t));
+            REQUIRE(t.kind == ABI::Type::FixedBytes);
+
+            // Malformed tuples
+            REQUIRE(ABI::Type::parse("()", json::array(), t));
+            REQUIRE(!ABI::Type::parse("()[2]", json::array(), t));
+            REQUIRE(!ABI::Type::parse("(())[3]", json::array(), t));
+            REQUIRE(!ABI::Type::parse("()[]", json::array(), t));
+            ABI::Function empty;
+            REQUIRE(!ABI::Function::fromJson({{"name", "f"},
+                {"inputs", {{{"type", "tuple[2]"}, {"components", json::array()}}}}}, empty));
+            REQUIRE(ABI::Type::parse("((uint256),bool)[]", json::array(), t));
+            REQUIRE(t.canonical() == "((uint256),bool)[]");
+            REQUIRE(!ABI::Type::parse("((uint256)", json::array(), t));
+            REQUIRE(!ABI::Type::parse("(uint256)x(bool)", json::array(), t));
+            REQUIRE(!ABI::Type::parse("(uint256))", json::array(), t));
+            REQUIRE(!ABI::Type::parse("(uint256,)", json::array(), t));
+            REQUIRE(!ABI::Type::parse("(,uint256)", json::array(), t));
+            REQUIRE(!ABI::Type::parse("(uint256,,bool)", json::array(), t));
+
+            // Lengths and static heads are capped
+            REQUIRE(ABI::Type::parse("uint8[65536]", json::array(), t));
+            REQUIRE(t.headSize() == ABI::Type::maxHeadSize);
+            REQUIRE(!ABI::Type::parse("uint8[65537]", json::array(), t));
+            REQUIRE(!ABI::Type::parse("uint256[1000000000]", json::array(), t));
+            REQUIRE(!ABI::Type::parse("uint256[2][65536]", json::array(), t));
+            REQUIRE(!ABI::Type::parse("uint256[65536][65536][65536][65536]", json::array(), t));
+            REQUIRE(!ABI::Type::parse("(uint256[65536],bool)", json::array(), t));
+            REQUIRE(ABI::Type::parse("string[65536][65536]", json::array(), t));
+        }
+
+        SECTION("Round Trip With Encoder")
+        {
+            ABI::Encoder enc(4);
+            enc.addUint(BigNumber("129831751235123"));
+            enc.addString("Hello World!");
+            enc.addAddressArray({
+                dev::Address("0xc4ea73d428ab6589c36905d0f0b01f3051740ff8"),
+                dev::Address("0x0a3b3f9e7a2c2a1b8d7f6a5e4c3b2a1908f7e6d5")
+            });
+            enc.addBool(true);
+            std::vector<ABI::Type> types;
+            REQUIRE(ABI::Type::fromJson(json::parse(
+                R"([{"type":"uint256"},{"type":"string"},{"type":"address[]"},{"type":"bool"}])"
+            ), types));
+            json out;
+            REQUIRE(ABI::Decoder(&enc.data()).decode(types, out));
+            REQUIRE(out == json::parse(R"(["129831751235123", "Hello World!",
+                ["0xc4ea73d428ab6589c36905d0f0b01f3051740ff8", "0x0a3b3f9e7a2c2a1b8d7f6a5e4c3b2a1908f7e6d5"],
+                "true"])"));
+        }
+
+        SECTION("Static Arrays, Tuples And Signed Ints")
+        {
+            // (int8, uint256[2], (bool, bytes4)) is fully static, so everything is inline
+            dev::bytes data = dev::fromHex(
+                word("ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff85") +
+                word("1") + word("2") + word("1") + "deadbeef" + std::string(56, '0')
+            );
+            json components = {{{"type", "bool"}}, {{"type", "bytes4"}}};
+            std::vector<ABI::Type> types(3);
+            REQUIRE(ABI::Type::parse("int8", json::array(), types[0]));
+            REQUIRE(ABI::Type::parse("uint256[2]", json::array(), types[1]));
+            REQUIRE(ABI::Type::parse("tuple", components, types[2]));
+            json out;
+            REQUIRE(ABI::Decoder(&data).decode(types, out));
+            REQUIRE(out == json::parse(R"(["-123", ["1", "2"], ["true", "0xdeadbeef"]])"));
+        }
+
+        SECTION("Dynamic Tuple")
+        {
+            // ((uint256, string)): head is an offset to the tuple, which has its own offsets
+            dev::bytes data = dev::fromHex(
+                word("20") + word("5") + word("40") + word("3") + "616263" + std::string(58, '0')
+            );
+            json components = {{{"type", "uint256"}}, {{"type", "string"}}};
+            ABI::Type t;
+            REQUIRE(ABI::Type::parse("tuple", components, t));
+            json out;
+            REQUIRE(ABI::Decoder(&data).decode(t, 0, out));
+            REQUIRE(out == json::parse(R"(["5", "abc"])"));
+        }
+
+        SECTION("Invalid Data")
+        {
+            ABI::Type str, arr;
+            REQUIRE(ABI::Type::parse("string", json::array(), str));
+            REQUIRE(ABI::Type::parse("uint256[]", json::array(), arr));
+            json out;
+            // Truncated word
+            dev::bytes data = dev::fromHex(std::string(62, '0'));
+            REQUIRE(!ABI::Decoder(&data).decode(str, 0, out));
+            // Offset past the end
+            data = dev::fromHex(word("40") + word("0"));
+            REQUIRE(!ABI::Decoder(&data).decode(str, 0, out));
+            // Length bigger than the data
+            data = dev::fromHex(word("20") + word("21") + word("0"));
+            REQUIRE(!ABI::Decoder(&data).decode(str, 0, out));
+            // Huge array length, rejected before allocating anything
+            data = dev::fromHex(word("20") + word("ffffffffffff"));
+            REQUIRE(!ABI::Decoder(&data).decode(arr, 0, out));
+            // Offset with garbage in its high bytes
+            data = dev::fromHex("01" + std::string(62, '0') + "20" + word("0"));
+            REQUIRE(!ABI::Decoder(&data).decode(str, 0, out));
+        }
+
+        SECTION("Revert Reasons")
+        {
+            std::vector<ABI::Function> errors(1);
+            REQUIRE(ABI::Function::fromJson(json::parse(R"({"type": "error",
+                "name": "InsufficientBalance", "inputs": [
+                {"name": "available", "type": "uint256"}, {"name": "required", "type": "uint256"}
+            ]})"), errors[0]));
+            REQUIRE(errors[0].signature == "InsufficientBalance(uint256,uint256)");
+
+            json out;
+            dev::bytes data = dev::fromHex("08c379a0" + word("20") + word("12") +
+                Utils::utf8ToHex("Not enough balance").substr(2) + std::string(28, '0'));
+            REQUIRE(ABI::decodeRevert(&data, errors, out));
+            REQUIRE(out == json({{"name", "Error"}, {"signature", "Error(string)"},
+                {"args", {"Not enough balance"}}}));
+
+            data = dev::fromHex("4e487b71" + word("11"));
+            REQUIRE(ABI::decodeRevert(&data, errors, out));
+            REQUIRE(out["name"] == "Panic");
+            REQUIRE(out["args"] == json({"17"}));
+
+            data = errors[0].selector;
+            dev::bytes args = dev::fromHex(word("64") + word("c8"));
+            data.insert(data.end(), args.begin(), args.end());
+            REQUIRE(ABI::decodeRevert(&data, errors, out));
+            REQUIRE(out["name"] == "InsufficientBalance");
+            REQUIRE(out["args"] == json({"100", "200"}));
+
+            // Known selector with bad data, then an unknown selector
+            data = dev::fromHex("4e487b71");
+            REQUIRE(!ABI::decodeRevert(&data, errors, out));
+            REQUIRE(out["name"] == "Panic");
+            data = dev::fromHex("aabbccdd" + word("1"));
+            REQUIRE(!ABI::decodeRevert(&data, errors, out));
+            REQUIRE(out.is_null());
+        }
+
+        SECTION("Contract Outputs And Reverts")
+        {
+            json abi = json::parse(R"([
+                {"type": "function", "name": "getInfo", "inputs": [],
+                 "outputs": [{"name": "", "type": "string"}, {"name": "", "type": "uint256"}]},
+                {"type": "error", "name": "Unauthorized", "inputs": [{"name": "who", "type": "address"}]}
+            ])");
+            Contract contract(abi, "0xc4ea73d428ab6589c36905d0f0b01f3051740ff8");
+            Error error;
+            json out = contract.decodeOutput("getInfo",
+                "0x" + word("40") + word("2a") + word("2") + "6869" + std::string(60, '0'), error);
+            REQUIRE(error.getCode() == 0);
+            REQUIRE(out == json({"hi", "42"}));
+
+            Error revertError;
+            out = contract.decodeRevert("0x" + Solidity::packFunction("Unauthorized(address)") +
+                word("c4ea73d428ab6589c36905d0f0b01f3051740ff8"), revertError);
+            REQUIRE(revertError.getCode() == 0);
+            REQUIRE(out["args"] == json({"0xc4ea73d428ab6589c36905d0f0b01f3051740ff8"}));
+
+            Error unknownError;
+            contract.decodeRevert("0xaabbccdd", unknownError);
+            REQUIRE(unknownError.getCode() == 40);
+            Error badError;
+            contract.decodeOutput("getInfo", "0x" + word("40"), badError);
+            REQUIRE(badError.getCode() == 39);
+            Error missingError;
+            contract.decodeOutput("notAFunction", "0x", missingError);
+            REQUIRE(missingError.getCode() == 17);
+        }
+    }
+
+    TEST_CASE("Test ABI Events")
+    {
+        const std::string transferTopic = "0xddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef";
+        const std::string from = "000000000000000000000000c4ea73d428ab6589c36905d0f0b01f3051740ff8";
+        const std::string to = "0000000000000000000000000a3b3f9e7a2c2a1b8d7f6a5e4c3b2a1908f7e6d5";
+        json erc20 = json::parse(R"([
+            {"type": "event", "name": "Transfer", "anonymous": false, "inputs": [
+                {"name": "from", "type": "address", "indexed": true},
+                {"name": "to", "type": "address", "indexed": true},
+                {"name": "value", "type": "uint256", "indexed": false}]},
+            {"type": "event", "name": "Approval", "anonymous": false, "inputs": [
+                {"name": "owner", "type": "address", "indexed": true},
+                {"name": "spender", "type": "address", "indexed": true},
+                {"name": "value", "type": "uint256", "indexed": false}]}
+        ])");
+        // ERC-721's Transfer has the same signature, but the token ID is indexed too
+        json erc721 = json::parse(R"([
+            {"type": "event", "name": "Transfer", "anonymous": false, "inputs": [
+                {"name": "from", "type": "address", "indexed": true},
+                {"name": "to", "type": "address", "indexed": true},
+                {"name": "tokenId", "type": "uint256", "indexed": true}]}
+        ])");
+
+        SECTION("Parse Events")
+        {
+            ABI::Event event;
+            REQUIRE(ABI::Event::fromJson(erc20[0], event));
+            REQUIRE(event.signature == "Transfer(address,address,uint256)");
+            REQUIRE("0x" + event.topic.hex() == transferTopic);
+            REQUIRE(event.topicCount == 3);
+            REQUIRE(event.dataTypes.size() == 1);
+
+            // Malformed entries are rejected instead of throwing
+            ABI::Function func;
+            REQUIRE(!ABI::Event::fromJson(json("Transfer"), event));
+            REQUIRE(!ABI::Event::fromJson({{"name", 1}}, event));
+            REQUIRE(!ABI::Event::fromJson({{"name", "E"}, {"anonymous", "no"}}, event));
+            REQUIRE(!ABI::Event::fromJson({{"name", "E"}, {"inputs", "uint256"}}, event));
+            REQUIRE(!ABI::Event::fromJson({{"name", "E"},
+                {"inputs", {{{"type", "uint256"}, {"indexed", 1}}}}}, event));
+            REQUIRE(!ABI::Function::fromJson(json::array(), func));
+            REQUIRE(!ABI::Function::fromJson({{"name", nullptr}}, func));
+            REQUIRE(!ABI::Function::fromJson({{"name", "f"}, {"inputs",
+                {{{"type", "tuple"}, {"components", {{{"type", "bool"}, {"name", 2}}}}}}}}, func));
+
+            ABI::EventRegistry registry;
+            REQUIRE(registry.add(json({"event", {{"type", 5}}, {{"type", "event"}, {"name", 5}}})) == 0);
+            REQUIRE(registry.add(json::object()) == 0);
+        }
+
+        SECTION("Dispatch By Topic")
+        {
+            ABI::EventRegistry registry;
+            REQUIRE(registry.add(erc20) == 2);
+            REQUIRE(registry.add(erc20) == 0);  // Same events from another token
+            REQUIRE(registry.add(erc721) == 1);
+            REQUIRE(registry.size() == 3);
+
+            json out;
+            json log = {{"topics", {transferTopic, "0x" + from, "0x" + to}}, {"data", "0x" + word("64")}};
+            REQUIRE(registry.decode(log, out));
+            REQUIRE(out == json({{"name", "Transfer"}, {"signature", "Transfer(address,address,uint256)"},
+                {"args", {"0xc4ea73d428ab6589c36905d0f0b01f3051740ff8",
+                "0x0a3b3f9e7a2c2a1b8d7f6a5e4c3b2a1908f7e6d5", "100"}}}));
+
+            log = {{"topics", {transferTopic, "0x" + from, "0x" + to, "0x" + word("7")}}, {"data", "0x"}};
+            REQUIRE(registry.decode(log, out));
+            REQUIRE(out["args"][2] == "7");
+
+            // Unknown topic, wrong topic count, truncated data, invalid hex
+            log = {{"topics", {"0x" + word("1")}}, {"data", "0x"}};
+            REQUIRE(!registry.decode(log, out));
+            log = {{"topics", {transferTopic, "0x" + from}}, {"data", "0x" + word("64")}};
+            REQUIRE(!registry.decode(log, out));
+            log = {{"topics", {transferTopic, "0x" + from, "0x" + to}}, {"data", "0x64"}};
+            REQUIRE(!registry.decode(log, out));
+            log = {{"topics", {transferTopic, "0x" + from, "0xzz" + to.substr(2)}}, {"data", "0x" + word("64")}};
+            REQUIRE(!registry.decode(log, out));
+        }
+
+        SECTION("Indexed Dynamic Values And Anonymous Events")
+        {
+            ABI::Event event;
+            REQUIRE(ABI::Event::fromJson(json::parse(R"({"type": "event", "name": "Named",
+                "anonymous": true, "inputs": [
+                {"name": "name", "type": "string", "indexed": true},
+                {"name": "note", "type": "string", "indexed": false}]})"), event));
+            REQUIRE(event.topicCount == 1);
+            dev::h256 hash = dev::sha3(std::string("abc"));
+            dev::bytes data = dev::fromHex(word("20") + word("2") + "6869" + std::string(60, '0'));
+            json out;
+            REQUIRE(event.decode({hash}, &data, out));
+            REQUIRE(out["args"] == json({"0x" + hash.hex(), "hi"}));
+
+            // Anonymous events can't be looked up by topic
+            ABI::EventRegistry registry;
+            registry.add(event);
+            REQUIRE(registry.size() == 0);
+        }
+
+        SECTION("Contract Logs")
+        {
+            Contract contract(erc20, "0xc4ea73d428ab6589c36905d0f0b01f3051740ff8");
+            REQUIRE(contract.events().size() == 2);
+            Error error;
+            json out = contract.decodeLog({{"topics", {transferTopic, "0x" + from, "0x" + to}},
+                {"data", "0x" + word("64")}}, error);
+            REQUIRE(error.getCode() == 0);
+            REQUIRE(out["name"] == "Transfer");
+
+            Error unknownError;
+            contract.decodeLog({{"topics", {"0x" + word("1")}}, {"data", "0x"}}, unknownError);
+            REQUIRE(unknownError.getCode() == 41);
+            Error hexError;
+            contract.decodeLog({{"topics", {"not a topic"}}, {"data", "0x"}}, hexError);
+            REQUIRE(hexError.getCode() == 41);
+            Error badError;
+            contract.decodeLog({{"topics", {transferTopic}}, {"data", "0x"}}, badError);
+            REQUIRE(badError.getCode() == 39);
+        }
+    }
+
+    TEST_CASE("Test ABI Full Type Coverage")
+    {
+        SECTION("Spec Examples")
+        {
+            // From the Solidity ABI spec
+            Error e1;
+            std::string packed = Solidity::packMulti(json::parse(R"([
+                {"t": "uint32", "v": "69"}, {"t": "bool", "v": "true"}
+            ])"), e1, "baz(uint32,bool)");
+            REQUIRE(e1.getCode() == 0);
+            REQUIRE(packed == "0xcdcd77c0" + word("45") + word("1"));
+
+            Error e2;
+            packed = Solidity::packMulti(json::parse(R"([
+                {"t": "bytes3[2]", "v": ["0x616263", "0x646566"]}
+            ])"), e2, "bar(bytes3[2])");
+            REQUIRE(e2.getCode() == 0);
+            REQUIRE(packed == "0xfce353f6" + std::string("616263") + std::string(58, '0') +
+                "646566" + std::string(58, '0'));
+
+            Error e3;
+            packed = Solidity::packMulti(json::parse(R"([
+                {"t": "uint256", "v": "291"}, {"t": "uint32[]", "v": ["1110", "1929"]},
+                {"t": "bytes10", "v": "0x31323334353637383930"}, {"t": "bytes", "v": "0x48656c6c6f2c20776f726c6421"}
+            ])"), e3, "f(uint256,uint32[],bytes10,bytes)");
+            REQUIRE(e3.getCode() == 0);
+            REQUIRE(packed == "0x8be65246" + word("123") + word("80") +
+                "3132333435363738393000000000000000000000000000000000000000000000" +
+                word("e0") + word("2") + word("456") + word("789") + word("d") +
+                "48656c6c6f2c20776f726c642100000000000000000000000000000000000000");
+
+            Error e4;
+            packed = Solidity::packMulti(json::parse(R"([
+                {"t": "uint256[][]", "v": [["1", "2"], ["3"]]},
+                {"t": "string[]", "v": ["one", "two", "three"]}
+            ])"), e4, "g(uint256[][],string[])");
+            REQUIRE(e4.getCode() == 0);
+            REQUIRE(packed == "0x2289b18c" + word("40") + word("140") + word("2") + word("40") +
+                word("a0") + word("2") + word("1") + word("2") + word("1") + word("3") +
+                word("3") + word("60") + word("a0") + word("e0") +
+                word("3") + "6f6e65" + std::string(58, '0') +
+                word("3") + "74776f" + std::string(58, '0') +
+                word("5") + "7468726565" + std::string(54, '0'));
+        }
+
+        SECTION("Signed Ints")
+        {
+            ABI::Type t;
+            REQUIRE(ABI::Type::parse("int8", json::array(), t));
+            ABI::Encoder enc(std::vector<ABI::Type>{t, t});
+            enc.add(t, "-1");
+            enc.add(t, "127");
+            REQUIRE(enc.hex() == "0x" + std::string(64, 'f') + word("7f"));
+            json out;
+            REQUIRE(ABI::Decoder(&enc.data()).decode(std::vector<ABI::Type>{t, t}, out));
+            REQUIRE(out == json({"-1", "127"}));
+        }
+
+        SECTION("Tuples Round Trip")
+        {
+            std::vector<ABI::Type> types(3);
+            REQUIRE(ABI::Type::parse("(uint256,bytes32)", json::array(), types[0]));
+            REQUIRE(ABI::Type::parse("(address,string)[]", json::array(), types[1]));
+            REQUIRE(ABI::Type::parse("uint8[2][2]", json::array(), types[2]));
+            REQUIRE(types[0].headSize() == 64);
+            REQUIRE(types[2].headSize() == 128);
+            json in = json::parse(R"([
+                ["5", "0x1111111111111111111111111111111111111111111111111111111111111111"],
+                [["0xc4ea73d428ab6589c36905d0f0b01f3051740ff8", "abc"],
+                 ["0x0a3b3f9e7a2c2a1b8d7f6a5e4c3b2a1908f7e6d5", ""]],
+                [["1", "2"], ["3", "4"]]
+            ])");
+            for (size_t i = 0; i < types.size(); i++) {
+                Error err;
+                REQUIRE(Solidity::checkType(types[i], in[i], err));
+            }
+            ABI::Encoder enc(types);
+            for (size_t i = 0; i < types.size(); i++) enc.add(types[i], in[i]);
+            REQUIRE(enc.complete());
+            // Static tuple and array are inline: 2 + 1 (offset) + 4 words of heads
+            REQUIRE(enc.data().size() > 7 * 32);
+            REQUIRE(enc.hex().substr(2, 7 * 64) == word("5") + std::string(64, '1') +
+                word("e0") + word("1") + word("2") + word("3") + word("4"));
+            json out;
+            REQUIRE(ABI::Decoder(&enc.data()).decode(types, out));
+            REQUIRE(out == in);
+        }
+
+        SECTION("Type Checks")
+        {
+            auto code = [](const std::string& type, const json& value) {
+                Error err;
+                Solidity::checkType(type, value, err);
+                return err.getCode();
+            };
+            REQUIRE(code("uint8", "255") == 0);
+            REQUIRE(code("uint8", "256") == 25);
+            REQUIRE(code("uint256", "115792089237316195423570985008687907853269984665640564039457584007913129639935") == 0);
+            REQUIRE(code("uint256", "115792089237316195423570985008687907853269984665640564039457584007913129639936") == 25);
+            REQUIRE(code("int8", "-128") == 0);
+            REQUIRE(code("int8", "-129") == 42);
+            REQUIRE(code("int8", "128") == 42);
+            REQUIRE(code("bytes4", "0xdeadbeef") == 0);
+            REQUIRE(code("bytes4", "0xdeadbeef00") == 28);
+            REQUIRE(code("uint256[2]", {"1", "2", "3"}) == 19);
+            REQUIRE(code("uint256[]", {"1", "x"}) == 20);
+            REQUIRE(code("(uint256,bool)", {"1", "maybe"}) == 27);
+            REQUIRE(code("(uint256,bool)", {"1"}) == 19);
+            REQUIRE(code("fixed128x18", "1") == 31);
+            REQUIRE(code("()[2]", {json::array(), json::array()}) == 31);
+            REQUIRE(code("(())[3]", json::array()) == 31);
+            REQUIRE(code("function", "f((uint256,bytes32)[],int8)") == 0);
+            REQUIRE(code("function", "f(uint7)") == 30);
+        }
+
+        SECTION("Contract With Structs And Fixed Bytes")
+        {
+            json abi = json::parse(R"([{"type": "function", "name": "swap", "outputs": [], "inputs": [
+                {"name": "id", "type": "bytes32"},
+                {"name": "order", "type": "tuple", "components": [
+                    {"name": "amount", "type": "uint"}, {"name": "path", "type": "address[]"}]}
+            ]}])");
+            Contract contract(abi, "0xc4ea73d428ab6589c36905d0f0b01f3051740ff8");
+            REQUIRE(contract.functors().at("swap") == Solidity::packFunction("swap(bytes32,(uint256,address[]))"));
+            json args = json::parse(R"([
+                "0x1111111111111111111111111111111111111111111111111111111111111111",
+                ["1000", ["0xc4ea73d428ab6589c36905d0f0b01f3051740ff8"]]
+            ])");
+            Error error;
+            std::string packed = contract(args, "swap", error);
+            REQUIRE(error.getCode() == 0);
+            Error multiErr;
+            REQUIRE(packed == Solidity::packMulti({
+                {{"t", "bytes32"}, {"v", args[0]}}, {{"t", "(uint256,address[])"}, {"v", args[1]}}
+            }, multiErr, "swap(bytes32,(uint256,address[]))"));
+            // bytes32 is a single static word, not an offset to dynamic bytes
+            REQUIRE(packed.substr(10, 64) == std::string(64, '1'));
+
+            // The function-first overload encodes the same way
+            Error legacyErr;
+            REQUIRE(contract("swap", args, legacyErr) == packed);
+            REQUIRE(legacyErr.getCode() == 0);
+            REQUIRE(contract.methods().count("swap") == 0);
+
+            json mixed = json::parse(R"([{"type": "function", "name": "g", "outputs": [], "inputs": [
+                {"name": "a", "type": "int8"}, {"name": "b", "type": "uint16[2]"}, {"name": "c", "type": "bytes4"}]},
+                {"type": "function", "name": "h", "outputs": [], "inputs": [{"name": "a", "type": "fixed128x18"}]},
+                {"type": "function", "name": "k", "outputs": [], "inputs": [
+                {"name": "a", "type": "tuple[2]", "components": []}]}])");
+            Contract other(mixed, "0xc4ea73d428ab6589c36905d0f0b01f3051740ff8");
+            Error e1, e2, e3, e4;
+            REQUIRE(other(std::string("g"), json::array({"-1", {"1", "2"}, "0xdeadbeef"}), e1) == Solidity::packMulti({
+                {{"t", "int8"}, {"v", "-1"}}, {{"t", "uint16[2]"}, {"v", {"1", "2"}}},
+                {{"t", "bytes4"}, {"v", "0xdeadbeef"}}}, e2, "g(int8,uint16[2],bytes4)"));
+            REQUIRE(e1.getCode() == 0);
+            other(std::string("h"), json::array({"1"}), e3);
+            REQUIRE(e3.getCode() == 31);
+            other(std::string("k"), json::array({json::array(), json::array()}), e4);
+            REQUIRE(e4.getCode() == 31);
+            REQUIRE(other.methods().empty());
+        }
+
+        SECTION("Contract Function Handles")
+        {
+            json abi = json::parse(R"([{"type": "function", "name": "transfer",
+                "inputs": [{"name": "to", "type": "address"}, {"name": "value", "type": "uint256"}],
+                "outputs": [{"name": "", "type": "bool"}]}])");
+            Contract contract(abi, "0xc4ea73d428ab6589c36905d0f0b01f3051740ff8");
+            Contract::Method transfer = contract.fn("transfer");
+            REQUIRE(transfer.valid());
+            REQUIRE(transfer.function().headSize == 64);
+            REQUIRE(!contract.fn("approve").valid());
+
+            json args = {"0xc4ea73d428ab6589c36905d0f0b01f3051740ff8", "100"};
+            Error e1, e2;
+            REQUIRE(transfer(args, e1) == contract(args, "transfer", e2));
+            REQUIRE(e1.getCode() == 0);
+
+            // The same buffer is reused across calls
+            dev::bytes buffer;
+            Error e3;
+            REQUIRE(transfer.encode(args, buffer, e3));
+            REQUIRE(buffer.size() == 4 + 64);
+            const uint8_t* data = buffer.data();
+            Error e4;
+            REQUIRE(transfer.encode({"0xc4ea73d428ab6589c36905d0f0b01f3051740ff8", "200"}, buffer, e4));
+            REQUIRE(buffer.data() == data);
+            REQUIRE(buffer.back() == 200);
+
+            Error e5;
+            REQUIRE(!transfer.encode({"0xc4ea73d428ab6589c36905d0f0b01f3051740ff8", "x"}, buffer, e5));
+            REQUIRE(e5.getCode() == 25);
+            REQUIRE(buffer.empty());
+            Error e6;
+            REQUIRE(!contract.fn("approve").encode(args, buffer, e6));
+            REQUIRE(e6.getCode() == 17);
+
+            Error e7;
+            REQUIRE(transfer.decodeOutput("0x" + word("1"), e7) == json({"true"}));
+
+            // Handles share the parsed function, so they outlive the contract
+            Contract::Method kept;
+            {
+                Contract copy = contract;
+                Contract temp(abi, "0xc4ea73d428ab6589c36905d0f0b01f3051740ff8");
+                kept = temp.fn("transfer");
+                REQUIRE(copy.fn("transfer").function().selector == transfer.function().selector);
+            }
+            Error e8, e9;
+            REQUIRE(kept(args, e8) == transfer(args, e9));
+        }
+
+        SECTION("Checked Encoding")
+        {
+            json abi = json::parse(R"([{"type": "function", "name": "f", "outputs": [], "inputs": [
+                {"name": "a", "type": "uint8"}, {"name": "b", "type": "int16[]"},
+                {"name": "c", "type": "tuple", "components": [{"type": "uint256"}, {"type": "bytes4"}]}]}])");
+            Contract contract(abi, "0xc4ea73d428ab6589c36905d0f0b01f3051740ff8");
+            Contract::Method f = contract.fn("f");
+            json args = {"255", {"-32768", "32767"}, {"1", "0xdeadbeef"}};
+            dev::bytes buffer;
+            Error ok, e1, e2, e3, e4, e5;
+            REQUIRE(f.encode(args, buffer, ok));
+            REQUIRE(Solidity::packMulti({{{"t", "uint8"}, {"v", args[0]}}, {{"t", "int16[]"}, {"v", args[1]}},
+                {{"t", "(uint256,bytes4)"}, {"v", args[2]}}}, e1, "f(uint8,int16[],(uint256,bytes4))")
+                == dev::toHexPrefixed(buffer));
+
+            REQUIRE(!f.encode({"256", {"1"}, {"1", "0x00"}}, buffer, e2));
+            REQUIRE(e2.getCode() == 25);
+            REQUIRE(!f.encode({"1", {"1", "32768"}, {"1", "0x00"}}, buffer, e3));
+            REQUIRE(e3.getCode() == 20);
+            REQUIRE(!f.encode({"1", {"1"}, {"1"}}, buffer, e4));
+            REQUIRE(e4.getCode() == 19);
+            REQUIRE(!f.encode({"1", json::array(), {"1", "0xdeadbeef00"}}, buffer, e5));
+            REQUIRE(e5.getCode() == 28);
+            REQUIRE(buffer.empty());
+
+            BigNumber num;
+            REQUIRE(ABI::parseUint("00255", 8, num));
+            REQUIRE(num == 255);
+            REQUIRE(ABI::parseUint("", 8, num));
+            REQUIRE(num == 0);
+            REQUIRE(!ABI::parseUint("256", 8, num));
+            REQUIRE(!ABI::parseUint("-1", 256, num));
+            REQUIRE(ABI::parseUint("115792089237316195423570985008687907853269984665640564039457584007913129639935", 256, num));
+            REQUIRE(!ABI::parseUint("115792089237316195423570985008687907853269984665640564039457584007913129639936", 256, num));
+        }
+    }
+}
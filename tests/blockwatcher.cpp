@@ -0,0 +1,59 @@
+#include "../src/libs/catch2/catch_amalgamated.hpp"
+#include "../include/web3cpp/BlockWatcher.h"
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+namespace TBlockWatcher
+{
+    // Nothing listens on this port, so polls fail and heads only come from notify()
+    std::unique_ptr<Provider> offlineProvider() {
+        return std::make_unique<Provider>("offline", "127.0.0.1", "/", 1, 1, "ETH", "");
+    }
+
+    TEST_CASE("Test BlockWatcher")
+    {
+        SECTION("Notify Only Newer Heads")
+        {
+            std::unique_ptr<Provider> provider = offlineProvider();
+            BlockWatcher watcher(provider, 50);
+            std::mutex headLock;
+            std::vector<uint64_t> heads;
+            uint64_t id = watcher.subscribe([&](uint64_t head){
+                std::lock_guard<std::mutex> lock(headLock);
+                heads.push_back(head);
+            });
+            REQUIRE(watcher.head() == 0);
+            watcher.notify(5);
+            watcher.notify(3);
+            watcher.notify(5);
+            watcher.notify(7);
+            REQUIRE(watcher.head() == 7);
+            {
+                std::lock_guard<std::mutex> lock(headLock);
+                REQUIRE(heads == std::vector<uint64_t>{5, 7});
+            }
+
+            watcher.unsubscribe(id);
+            watcher.notify(8);
+            REQUIRE(watcher.head() == 8);
+            std::lock_guard<std::mutex> lock(headLock);
+            REQUIRE(heads.size() == 2);
+        }
+
+        SECTION("Unsubscribe From Inside A Callback")
+        {
+            std::unique_ptr<Provider> provider = offlineProvider();
+            BlockWatcher watcher(provider, 50);
+            int calls = 0;
+            uint64_t id = 0;
+            id = watcher.subscribe([&](uint64_t){ calls++; watcher.unsubscribe(id); });
+            watcher.notify(1);
+            watcher.notify(2);
+            REQUIRE(calls == 1);
+        }
+    }
+}
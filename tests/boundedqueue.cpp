@@ -0,0 +1,47 @@
+#include "../src/libs/catch2/catch_amalgamated.hpp"
+#include "../include/web3cpp/BoundedQueue.h"
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace TBoundedQueue
+{
+    TEST_CASE("Test BoundedQueue")
+    {
+        SECTION("FIFO Order And Close")
+        {
+            BoundedQueue<int> q(4);
+            REQUIRE(q.push(1));
+            REQUIRE(q.push(2));
+            REQUIRE(q.size() == 2);
+            q.close();
+            REQUIRE(!q.push(3));
+            int item = 0;
+            REQUIRE(q.pop(item));
+            REQUIRE(item == 1);
+            REQUIRE(q.tryPop(item));
+            REQUIRE(item == 2);
+            REQUIRE(!q.pop(item));
+        }
+
+        SECTION("Backpressure Between Threads")
+        {
+            BoundedQueue<int> q(2);
+            std::thread producer([&q]{
+                for (int i = 0; i < 1000; i++) q.push(i);
+                q.close();
+            });
+            std::vector<int> received;
+            int item = 0;
+            while (q.pop(item)) {
+                REQUIRE(q.size() <= 2);
+                received.push_back(item);
+            }
+            producer.join();
+            REQUIRE(received.size() == 1000);
+            for (int i = 0; i < 1000; i++) REQUIRE(received[i] == i);
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#include "../src/libs/catch2/catch_amalgamated.hpp"
+#include "../include/web3cpp/ConfirmationTracker.h"
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <memory>
+
+using namespace std;
+
+namespace TConfirmationTracker
+{
+    const std::string hash = "0x0000000000000000000000000000000000000000000000000000000000000001";
+
+    // Nothing listens on this port, so no receipt is ever found
+    std::unique_ptr<Provider> offlineProvider() {
+        return std::make_unique<Provider>("offline", "127.0.0.1", "/", 1, 1, "ETH", "");
+    }
+
+    TEST_CASE("Test ConfirmationTracker")
+    {
+        SECTION("Timeout Without New Heads")
+        {
+            std::unique_ptr<Provider> provider = offlineProvider();
+            BlockWatcher watcher(provider, 60000);
+            ConfirmationTracker tracker(watcher, 1, 1);
+            std::atomic<int> calls{0};
+            std::future<ConfirmationTracker::Status> f = tracker.watch(
+                hash, [&calls](const ConfirmationTracker::Status&){ calls++; }
+            );
+            REQUIRE(tracker.pending() == 1);
+
+            // No head ever shows up, the deadline alone resolves it
+            REQUIRE(f.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+            ConfirmationTracker::Status status = f.get();
+            REQUIRE(status.hash == hash);
+            REQUIRE(status.errorCode == 37);
+            REQUIRE(status.receipt.is_null());
+            REQUIRE(calls == 1);
+            REQUIRE(tracker.pending() == 0);
+        }
+
+        SECTION("Heads Are Checked Off The Watcher Thread")
+        {
+            std::unique_ptr<Provider> provider = offlineProvider();
+            BlockWatcher watcher(provider, 60000);
+            std::future<ConfirmationTracker::Status> f;
+            {
+                ConfirmationTracker tracker(watcher, 1, 60);
+                f = tracker.watch(hash);
+                for (uint64_t head = 1; head <= 100; head++) watcher.notify(head);
+                REQUIRE(tracker.pending() == 1);
+                REQUIRE(f.wait_for(std::chrono::milliseconds(100)) == std::future_status::timeout);
+            }
+
+            // Watches still pending are resolved as timed out on destruction
+            REQUIRE(f.wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+            ConfirmationTracker::Status status = f.get();
+            REQUIRE(status.errorCode == 37);
+            REQUIRE(status.confirmations == 0);
+        }
+    }
+}
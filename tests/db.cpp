@@ -109,6 +109,242 @@ namespace TDb
 
             db.dropDatabase();
         }
+
+        SECTION("Point Lookups")
+        {
+            boost::filesystem::path walletFolder = "web3cpp-test-wallet";
+            Database db("testlookupdb", walletFolder);
+            REQUIRE(db.putKeyValue("empty", ""));
+            REQUIRE(db.putKeyValue("full", "value"));
+
+            std::string value = "untouched";
+            REQUIRE(db.keyExists("empty"));
+            REQUIRE(!db.keyExists("missing"));
+            REQUIRE(!db.getKeyValue("missing", value));
+            REQUIRE(value == "untouched");
+            REQUIRE(db.getKeyValue("empty", value));
+            REQUIRE(value == "");
+            REQUIRE(db.getKeyValue("full", value));
+            REQUIRE(value == "value");
+
+            db.dropDatabase();
+        }
+
+        SECTION("Write Batches")
+        {
+            boost::filesystem::path walletFolder = "web3cpp-test-wallet";
+            Database db("testbatchdb", walletFolder);
+            Database accounts = db.partition("accounts/");
+            Database other("testbatchdb2", walletFolder);
+            REQUIRE(db.putKeyValue("old", "value"));
+
+            Database::Batch batch = db.batch();
+            batch.put("key0", "value0");
+            batch.put("key1", "value1");
+            batch.del("old");
+            REQUIRE(batch.put(accounts, "key", "account value"));
+            REQUIRE(!batch.put(other, "key", "value"));
+            REQUIRE(batch.size() == 4);
+
+            // Nothing is visible before committing
+            REQUIRE(!db.keyExists("key0"));
+            REQUIRE(db.keyExists("old"));
+            REQUIRE(batch.commit(true));
+            REQUIRE(batch.size() == 0);
+            REQUIRE(db.getKeyValue("key1") == "value1");
+            REQUIRE(!db.keyExists("old"));
+            REQUIRE(accounts.getKeyValue("key") == "account value");
+            REQUIRE(!other.keyExists("key"));
+
+            Database::Batch discarded = db.batch();
+            discarded.put("key2", "value2");
+            discarded.rollback();
+            REQUIRE(discarded.commit());
+            REQUIRE(!db.keyExists("key2"));
+
+            REQUIRE(db.dropDatabase());
+            REQUIRE(db.getAllKeys().empty());
+        }
+
+        SECTION("Cursors")
+        {
+            boost::filesystem::path walletFolder = "web3cpp-test-wallet";
+            Database root("testcursordb", walletFolder);
+            Database db = root.partition("part/");
+            REQUIRE(root.putKeyValue("outside", "x"));
+            for (std::string k : {"a1", "a2", "a3", "b1", "b2", "c1"}) {
+                REQUIRE(db.putKeyValue(k, "v" + k));
+            }
+            auto collect = [](Database::Cursor c) {
+                std::vector<std::string> keys;
+                for (; c.valid(); c.next()) keys.emplace_back(c.key());
+                return keys;
+            };
+
+            REQUIRE(collect(db.cursor()) == std::vector<std::string>{"a1", "a2", "a3", "b1", "b2", "c1"});
+            Database::Range prefix;
+            prefix.prefix = "a";
+            REQUIRE(collect(db.cursor(prefix)) == std::vector<std::string>{"a1", "a2", "a3"});
+            prefix.reverse = true;
+            REQUIRE(collect(db.cursor(prefix)) == std::vector<std::string>{"a3", "a2", "a1"});
+
+            Database::Range range;
+            range.start = "a2";
+            range.end = "b2";
+            REQUIRE(collect(db.cursor(range)) == std::vector<std::string>{"a2", "a3", "b1"});
+            range.reverse = true;
+            range.limit = 2;
+            REQUIRE(collect(db.cursor(range)) == std::vector<std::string>{"b1", "a3"});
+
+            Database::Range all;
+            all.reverse = true;
+            REQUIRE(collect(db.cursor(all)) == std::vector<std::string>{"c1", "b2", "b1", "a3", "a2", "a1"});
+
+            Database::Cursor c = db.cursor(prefix);
+            REQUIRE(c.value() == "va3");
+
+            // Snapshots don't see later writes
+            Database snap = db.snapshot();
+            REQUIRE(db.putKeyValue("a4", "va4"));
+            REQUIRE(db.deleteKeyValue("a1"));
+            REQUIRE(snap.keyExists("a1"));
+            REQUIRE(!snap.keyExists("a4"));
+            REQUIRE(collect(snap.cursor()).size() == 6);
+            REQUIRE(db.getKeyValue("a4") == "va4");
+
+            root.dropDatabase();
+        }
+
+        SECTION("Tuning Options")
+        {
+            boost::filesystem::path walletFolder = "web3cpp-test-wallet";
+            DatabaseOptions readOpts = DatabaseOptions::readHeavy();
+            DatabaseOptions writeOpts = DatabaseOptions::writeHeavy();
+            REQUIRE(readOpts.cacheSize > DatabaseOptions().cacheSize);
+            REQUIRE(writeOpts.writeBufferSize > DatabaseOptions().writeBufferSize);
+
+            // Two databases bound by the same cache budget
+            std::shared_ptr<leveldb::Cache> cache = DatabaseOptions::sharedCache(16 << 20);
+            readOpts.cache = cache;
+            writeOpts.cache = cache;
+            writeOpts.bloomBitsPerKey = 0;
+            writeOpts.compression = false;
+            Database readDB("testreadopts", walletFolder, readOpts);
+            Database writeDB("testwriteopts", walletFolder, writeOpts);
+            REQUIRE(readDB.isOpen());
+            REQUIRE(writeDB.isOpen());
+            REQUIRE(readDB.getOptions().cache == writeDB.getOptions().cache);
+            REQUIRE(readDB.putKeyValue("key", "value"));
+            REQUIRE(writeDB.putKeyValue("key", "value"));
+            REQUIRE(readDB.getKeyValue("key") == writeDB.getKeyValue("key"));
+
+            readDB.dropDatabase();
+            writeDB.dropDatabase();
+        }
+
+        SECTION("Memory Backend")
+        {
+            Database db = Database::inMemory();
+            REQUIRE(db.isOpen());
+            Database part = db.partition("part/");
+            REQUIRE(part.putKeyValue("b", "2"));
+            REQUIRE(part.putKeyValue("a", "1"));
+            REQUIRE(db.putKeyValue("z", "26"));
+            REQUIRE(part.getAllKeys() == std::vector<std::string>{"a", "b"});
+            REQUIRE(db.getKeyValue("part/a") == "1");
+
+            // Snapshots and open cursors keep their view after writes
+            Database snap = part.snapshot();
+            Database::Cursor c = part.cursor();
+            Database::Batch batch = part.batch();
+            batch.put("c", "3");
+            batch.del("a");
+            REQUIRE(batch.commit());
+            REQUIRE(snap.keyExists("a"));
+            REQUIRE(!snap.keyExists("c"));
+            REQUIRE(c.key() == "a");
+            REQUIRE(part.getAllKeys() == std::vector<std::string>{"b", "c"});
+
+            Database::Range reverse;
+            reverse.reverse = true;
+            Database::Cursor r = db.cursor(reverse);
+            REQUIRE(r.key() == "z");
+            REQUIRE(part.dropDatabase());
+            REQUIRE(db.getAllKeys() == std::vector<std::string>{"z"});
+        }
+
+        SECTION("Table Backend")
+        {
+            boost::filesystem::path walletFolder = "web3cpp-test-wallet";
+            boost::filesystem::create_directories(walletFolder);
+            boost::filesystem::path tableFile = walletFolder / "test.table";
+            Database source = Database::inMemory();
+            for (int i = 0; i < 100; i++) {
+                char key[8];
+                std::snprintf(key, sizeof(key), "k%03d", i);
+                REQUIRE(source.putKeyValue(key, "value" + std::to_string(i)));
+            }
+            REQUIRE(source.putKeyValue("empty", ""));
+            REQUIRE(source.exportTable(tableFile));
+
+            Database table = Database::openTable(tableFile);
+            REQUIRE(table.isOpen());
+            REQUIRE(table.getAllPairs() == source.getAllPairs());
+            REQUIRE(table.getKeyValue("k042") == "value42");
+            std::string value = "untouched";
+            REQUIRE(table.getKeyValue("empty", value));
+            REQUIRE(value.empty());
+            REQUIRE(!table.keyExists("k100"));
+            REQUIRE(!table.keyExists("a"));
+
+            Database::Range range;
+            range.start = "k010";
+            range.end = "k013";
+            range.reverse = true;
+            std::vector<std::string> keys;
+            for (Database::Cursor c = table.cursor(range); c.valid(); c.next()) keys.emplace_back(c.key());
+            REQUIRE(keys == std::vector<std::string>{"k012", "k011", "k010"});
+
+            // Tables are read-only
+            REQUIRE(!table.putKeyValue("k000", "new"));
+            REQUIRE(table.getKeyValue("k000") == "value0");
+
+            // Out of order keys are rejected
+            TableBackend::Writer writer(walletFolder / "bad.table");
+            REQUIRE(writer.add("b", "1"));
+            REQUIRE(!writer.add("a", "2"));
+            REQUIRE(!Database::openTable(walletFolder / "missing.table").isOpen());
+            boost::filesystem::remove(tableFile);
+            boost::filesystem::remove(walletFolder / "bad.table");
+        }
+
+        SECTION("Partitions")
+        {
+            boost::filesystem::path walletFolder = "web3cpp-test-wallet";
+            Database db("testpartdb", walletFolder);
+            Database accounts = db.partition("accounts/");
+            Database history = db.partition("tx/");
+            Database nested = history.partition("0xabc/");
+
+            REQUIRE(accounts.putKeyValue("key", "account value"));
+            REQUIRE(history.putKeyValue("key", "history value"));
+            REQUIRE(nested.putKeyValue("key", "nested value"));
+            REQUIRE(db.keyExists("accounts/key"));
+            REQUIRE(accounts.getKeyValue("key") == "account value");
+            REQUIRE(nested.getKeyValue("key") == "nested value");
+            REQUIRE(db.getKeyValue("tx/0xabc/key") == "nested value");
+            REQUIRE(!accounts.keyExists("0xabc/key"));
+            REQUIRE(accounts.getAllKeys() == std::vector<std::string>{"key"});
+            REQUIRE(history.getAllKeys() == std::vector<std::string>{"0xabc/key", "key"});
+
+            // Dropping a partition leaves the others untouched
+            history.dropDatabase();
+            REQUIRE(nested.getAllKeys().empty());
+            REQUIRE(accounts.getKeyValue("key") == "account value");
+
+            db.dropDatabase();
+            REQUIRE(db.getAllKeys().empty());
+        }
     }
 
 }
\ No newline at end of file
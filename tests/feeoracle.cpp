@@ -0,0 +1,112 @@
+#include "../src/libs/catch2/catch_amalgamated.hpp"
+#include "../include/web3cpp/FeeOracle.h"
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+using namespace std;
+
+namespace TFeeOracle
+{
+    // Nothing listens on this port, so every request fails
+    std::unique_ptr<Provider> offlineProvider() {
+        return std::make_unique<Provider>("offline", "127.0.0.1", "/", 1, 1, "ETH", "");
+    }
+
+    json result(const json& value) {
+        json ret;
+        ret["jsonrpc"] = "2.0";
+        ret["id"] = 1;
+        ret["result"] = value;
+        return ret;
+    }
+
+    const json price = result("0x3b9aca00");  // 1 gwei
+    const json block = result({{"number", "0x64"}, {"baseFeePerGas", "0x77359400"}});  // 2 gwei
+    const json history = result({
+        {"oldestBlock", "0x62"},
+        {"baseFeePerGas", json::array({"0x77359400", "0x77359400", "0x77359400", "0xb2d05e00"})},  // next: 3 gwei
+        {"reward", json::array({
+            json::array({"0x1", "0x64", "0x3e8"}),
+            json::array({"0x2", "0xc8", "0x7d0"}),
+            json::array({"0x3", "0x12c", "0xbb8"})
+        })}
+    });
+
+    TEST_CASE("Test FeeOracle")
+    {
+        SECTION("Percentile Validation")
+        {
+            std::unique_ptr<Provider> provider = offlineProvider();
+            BlockWatcher watcher(provider, 60000);
+            REQUIRE_THROWS_AS(FeeOracle(watcher, {}), std::invalid_argument);
+            REQUIRE_THROWS_AS(FeeOracle(watcher, {10, 101}), std::invalid_argument);
+            REQUIRE_THROWS_AS(FeeOracle(watcher, {-1}), std::invalid_argument);
+            REQUIRE_THROWS_AS(FeeOracle(watcher, {std::nan("")}), std::invalid_argument);
+            FeeOracle oracle(watcher, {90, 10, 50, 10});
+            REQUIRE(!oracle.ready());
+        }
+
+        SECTION("Update From Responses")
+        {
+            std::unique_ptr<Provider> provider = offlineProvider();
+            BlockWatcher watcher(provider, 60000);
+            FeeOracle oracle(watcher, {90, 10, 50, 10});
+            REQUIRE(oracle.update(100, price, history, block));
+            std::shared_ptr<const FeeOracle::Snapshot> s = oracle.snapshot();
+            REQUIRE(s->block == 100);
+            REQUIRE(s->percentiles == std::vector<double>{10, 50, 90});
+            REQUIRE(s->gasPrice == BigNumber(1000000000));
+            REQUIRE(s->baseFee == BigNumber(2000000000));
+            REQUIRE(s->nextBaseFee == BigNumber(3000000000));
+            REQUIRE(s->priorityFees == std::vector<BigNumber>{2, 200, 2000});
+
+            REQUIRE(oracle.maxPriorityFee() == BigNumber(200));
+            REQUIRE(oracle.maxPriorityFee(85) == BigNumber(2000));
+            REQUIRE(oracle.maxFee() == BigNumber(6000000200));
+            REQUIRE(oracle.gasPrice() == BigNumber(3000000200));
+        }
+
+        SECTION("Update Without Fee History")
+        {
+            std::unique_ptr<Provider> provider = offlineProvider();
+            BlockWatcher watcher(provider, 60000);
+            FeeOracle oracle(watcher);
+            json noHistory;
+            noHistory["error"]["code"] = -32601;
+            REQUIRE(oracle.update(5, price, noHistory, result({{"number", "0x5"}})));
+            REQUIRE(oracle.snapshot()->nextBaseFee == 0);
+            REQUIRE(oracle.maxPriorityFee() == 0);
+            REQUIRE(oracle.gasPrice() == BigNumber(1000000000));
+        }
+
+        SECTION("Invalid Responses Keep The Previous Snapshot")
+        {
+            std::unique_ptr<Provider> provider = offlineProvider();
+            BlockWatcher watcher(provider, 60000);
+            FeeOracle oracle(watcher);
+            REQUIRE(oracle.update(100, price, history, block));
+
+            json badHistory = history;
+            badHistory["result"]["reward"][1][2] = "not hex";
+            json wrongType = history;
+            wrongType["result"]["baseFeePerGas"] = "0x1";
+            json numberPrice = result(1000000000);
+            json badBlock = result({{"baseFeePerGas", 7}});
+
+            REQUIRE(!oracle.update(101, result("0x"), history, block));
+            REQUIRE(!oracle.update(101, result("0xzz"), history, block));
+            REQUIRE(!oracle.update(101, numberPrice, history, block));
+            REQUIRE(!oracle.update(101, json(), history, block));
+            REQUIRE(!oracle.update(101, price, badHistory, block));
+            REQUIRE(!oracle.update(101, price, wrongType, block));
+            REQUIRE(!oracle.update(101, price, history, badBlock));
+            REQUIRE(oracle.snapshot()->block == 100);
+
+            // A failed request doesn't replace it either
+            REQUIRE(!oracle.refresh(101));
+            REQUIRE(oracle.snapshot()->block == 100);
+            REQUIRE(oracle.gasPrice() == BigNumber(3000000200));
+        }
+    }
+}
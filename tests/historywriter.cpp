@@ -0,0 +1,76 @@
+#include "../src/libs/catch2/catch_amalgamated.hpp"
+#include "../include/web3cpp/HistoryWriter.h"
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+namespace THistoryWriter
+{
+    // EIP-155 example transaction
+    const std::string signedTx = "0xf86c098504a817c800825208943535353535353535353535353535353535353535880de0b6b3a76400008025a028ef61340bd939bc2195fe537567866003e1a15d3c71ff63e1590620aa636276a067cbe9d8997f761aecb703304b3800ccf555c9f3dc64214b297fb1966a3b6d83";
+
+    TEST_CASE("Test HistoryWriter")
+    {
+        SECTION("Flush Writes Queued Transactions")
+        {
+            Database db = Database::inMemory();
+            Database history = db.partition("tx/0x9d8a62f656a8d1615c1294fd71e9cfb3e4855a4f/");
+            TxIndex index(history, dev::Address("0x9d8a62f656a8d1615c1294fd71e9cfb3e4855a4f"));
+            std::string hash = TxRecord::fromSignedTx(signedTx).key();
+
+            HistoryWriter writer(db, 16, 64);
+            for (int i = 0; i < 100; i++) REQUIRE(writer.enqueue(index, signedTx));
+            REQUIRE(writer.flush());
+            REQUIRE(writer.pending() == 0);
+            REQUIRE(history.keyExists(hash));
+            REQUIRE(index.byTime(0).size() == 1);
+        }
+
+        SECTION("Flush Reports Failed Transactions")
+        {
+            Database db = Database::inMemory();
+            TxIndex history(db.partition("tx/"), dev::Address());
+            HistoryWriter writer(db);
+            REQUIRE(writer.enqueue(history, "0x1234"));
+            REQUIRE(!writer.flush());
+            // The failure is only reported once
+            REQUIRE(writer.enqueue(history, signedTx));
+            REQUIRE(writer.flush());
+            REQUIRE(history.byTime(0).size() == 1);
+        }
+
+        SECTION("Transactions Are Dated When Queued")
+        {
+            Database db = Database::inMemory();
+            TxIndex history(db.partition("tx/"), dev::Address());
+            HistoryWriter writer(db);
+            uint64_t before = std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+            REQUIRE(writer.enqueue(history, signedTx));
+            uint64_t after = std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+
+            // Written well after it was queued, still dated at enqueue time
+            std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+            REQUIRE(writer.flush());
+            std::vector<TxRecord> records = history.byTime(0);
+            REQUIRE(records.size() == 1);
+            REQUIRE(records[0].unixDate >= before);
+            REQUIRE(records[0].unixDate <= after);
+        }
+
+        SECTION("Destructor Drains The Queue")
+        {
+            Database db = Database::inMemory();
+            TxIndex history(db.partition("tx/"), dev::Address());
+            {
+                HistoryWriter writer(db);
+                REQUIRE(writer.enqueue(history, signedTx));
+            }
+            REQUIRE(history.byTime(0).size() == 1);
+        }
+    }
+}
@@ -0,0 +1,238 @@
+#include "../src/libs/catch2/catch_amalgamated.hpp"
+#include "../include/web3cpp/NonceManager.h"
+#include <iostream>
+#include <memory>
+#include <string>
+
+using namespace std;
+
+namespace TNonceManager
+{
+    const std::string address = "0x9d8a62f656a8d1615c1294fd71e9cfb3e4855a4f";
+    // No provider, so nothing ever reaches the network
+    const std::unique_ptr<Provider> provider;
+
+    TEST_CASE("Test NonceManager")
+    {
+        SECTION("Next Without Sync Or Provider")
+        {
+            Database db = Database::inMemory();
+            NonceManager nonces(address, provider, db);
+            Error err;
+            REQUIRE(nonces.next(err) == 0);
+            REQUIRE(err.getCode() == 43);
+            REQUIRE(nonces.pending().empty());
+        }
+
+        SECTION("Peek Is Local Only")
+        {
+            Database db = Database::inMemory();
+            {
+                NonceManager nonces(address, provider, db);
+                REQUIRE(!nonces.isSynced());
+                REQUIRE(nonces.peek() == 0);
+                nonces.sync(4);
+                REQUIRE(nonces.isSynced());
+                REQUIRE(nonces.peek() == 4);
+            }
+
+            // The persisted state is loaded on construction, still unsynced
+            NonceManager reloaded(address, provider, db);
+            REQUIRE(!reloaded.isSynced());
+            REQUIRE(reloaded.peek() == 4);
+        }
+
+        SECTION("Next And MarkSent")
+        {
+            Database db = Database::inMemory();
+            NonceManager nonces(address, provider, db);
+            nonces.sync(5);
+            Error e1, e2, e3;
+            REQUIRE(nonces.next(e1) == 5);
+            REQUIRE(nonces.next(e2) == 6);
+            REQUIRE(nonces.next(e3) == 7);
+            REQUIRE(e3.getCode() == 0);
+            REQUIRE(nonces.pending().size() == 3);
+            REQUIRE(nonces.pending().at(6) == "");
+
+            nonces.markSent(6, "0xabc");
+            REQUIRE(nonces.pending().at(6) == "0xabc");
+            REQUIRE(nonces.peek() == 8);
+        }
+
+        SECTION("MarkFailed Highest Nonce")
+        {
+            Database db = Database::inMemory();
+            NonceManager nonces(address, provider, db);
+            nonces.sync(0);
+            Error e1, e2, e3;
+            REQUIRE(nonces.next(e1) == 0);
+            REQUIRE(nonces.next(e2) == 1);
+            nonces.markFailed(1);
+            REQUIRE(nonces.pending().size() == 1);
+            REQUIRE(nonces.next(e3) == 1);
+        }
+
+        SECTION("MarkFailed Leaves Later Nonces Alone")
+        {
+            Database db = Database::inMemory();
+            NonceManager nonces(address, provider, db);
+            nonces.sync(10);
+            Error e1, e2, e3, e4, e5;
+            REQUIRE(nonces.next(e1) == 10);
+            REQUIRE(nonces.next(e2) == 11);
+            REQUIRE(nonces.next(e3) == 12);
+
+            // 11 becomes a gap, 12 is still outstanding and is never reissued
+            nonces.markFailed(11);
+            REQUIRE(nonces.pending().count(11) == 0);
+            REQUIRE(nonces.pending().count(12) == 1);
+            REQUIRE(nonces.next(e4) == 11);
+            REQUIRE(nonces.next(e5) == 13);
+
+            // Releasing an unknown or already released nonce does nothing
+            nonces.markFailed(50);
+            nonces.markFailed(11);
+            nonces.markFailed(11);
+            Error e6, e7;
+            REQUIRE(nonces.next(e6) == 11);
+            REQUIRE(nonces.next(e7) == 14);
+        }
+
+        SECTION("MarkFailed Collapses Gaps Below The Top")
+        {
+            Database db = Database::inMemory();
+            NonceManager nonces(address, provider, db);
+            nonces.sync(0);
+            Error e1, e2, e3, e4, e5;
+            nonces.next(e1); nonces.next(e2); nonces.next(e3);
+            nonces.markFailed(1);
+            nonces.markFailed(2);
+            REQUIRE(nonces.pending().size() == 1);
+            REQUIRE(nonces.next(e4) == 1);
+            REQUIRE(nonces.next(e5) == 2);
+        }
+
+        SECTION("FillGap")
+        {
+            Database db = Database::inMemory();
+            NonceManager nonces(address, provider, db);
+            nonces.sync(0);
+            Error e1, e2, e3, e4, e5;
+            nonces.next(e1); nonces.next(e2); nonces.next(e3); nonces.next(e4);
+
+            // Nothing released yet, so every nonce stays as it is
+            REQUIRE(nonces.fillGap(3) == 3);
+
+            // 1 failed, 2 and 3 weren't sent yet and move down into the gap
+            nonces.markFailed(1);
+            REQUIRE(nonces.fillGap(0) == 0);
+            REQUIRE(nonces.fillGap(2) == 1);
+            REQUIRE(nonces.fillGap(3) == 2);
+            REQUIRE(nonces.pending().size() == 3);
+            REQUIRE(nonces.pending().count(3) == 0);
+            REQUIRE(nonces.next(e5) == 3);
+
+            // Unknown nonces are left alone
+            nonces.markFailed(0);
+            REQUIRE(nonces.fillGap(50) == 50);
+        }
+
+        SECTION("Sync Only Moves Forward")
+        {
+            Database db = Database::inMemory();
+            NonceManager nonces(address, provider, db);
+            nonces.sync(3);
+            Error e1, e2, e3, e4;
+            REQUIRE(nonces.next(e1) == 3);
+            REQUIRE(nonces.next(e2) == 4);
+
+            // The node hasn't seen 3 and 4 yet
+            nonces.sync(3);
+            REQUIRE(nonces.next(e3) == 5);
+            REQUIRE(nonces.pending().size() == 3);
+
+            // The node moved past what was handed out locally
+            nonces.sync(10);
+            REQUIRE(nonces.next(e4) == 10);
+        }
+
+        SECTION("Sync Drops Gaps The Node Already Has")
+        {
+            Database db = Database::inMemory();
+            NonceManager nonces(address, provider, db);
+            nonces.sync(0);
+            Error e1, e2, e3, e4;
+            nonces.next(e1); nonces.next(e2); nonces.next(e3);
+            nonces.markFailed(0);
+            nonces.sync(1);
+            REQUIRE(nonces.next(e4) == 3);
+        }
+
+        SECTION("MarkConfirmed")
+        {
+            Database db = Database::inMemory();
+            NonceManager nonces(address, provider, db);
+            nonces.sync(0);
+            Error e1, e2, e3, e4;
+            nonces.next(e1); nonces.next(e2); nonces.next(e3);
+            nonces.markConfirmed(1);
+            REQUIRE(nonces.pending().size() == 1);
+            REQUIRE(nonces.pending().count(2) == 1);
+            REQUIRE(nonces.next(e4) == 3);
+        }
+
+        SECTION("Persistence")
+        {
+            Database db = Database::inMemory();
+            {
+                NonceManager nonces(address, provider, db);
+                nonces.sync(5);
+                Error e1, e2, e3;
+                nonces.next(e1); nonces.next(e2); nonces.next(e3);
+                nonces.markSent(5, "0xa");
+                nonces.markSent(7, "0xc");
+                nonces.markFailed(6);
+            }
+            REQUIRE(!db.getKeyValue(NonceManager::dbKey).empty());
+
+            // Reloaded without the network, the stored state is used as is
+            NonceManager reloaded(address, provider, db);
+            Error e4, e5;
+            REQUIRE(reloaded.next(e4) == 6);
+            REQUIRE(e4.getCode() == 0);
+            REQUIRE(reloaded.next(e5) == 8);
+            std::map<uint64_t, std::string> pending = reloaded.pending();
+            REQUIRE(pending.size() == 4);
+            REQUIRE(pending.at(5) == "0xa");
+            REQUIRE(pending.at(7) == "0xc");
+        }
+
+        SECTION("Persistence With First Sync")
+        {
+            Database db = Database::inMemory();
+            {
+                NonceManager nonces(address, provider, db);
+                nonces.sync(5);
+                Error e1, e2, e3;
+                nonces.next(e1); nonces.next(e2); nonces.next(e3);
+                nonces.markSent(5, "0xa");
+                nonces.markSent(6, "0xb");
+            }
+
+            // Only 5 and 6 reached the node before the restart
+            NonceManager reloaded(address, provider, db);
+            reloaded.sync(7);
+            std::map<uint64_t, std::string> pending = reloaded.pending();
+            REQUIRE(pending.size() == 2);
+            REQUIRE(pending.at(6) == "0xb");
+
+            // The dropped nonce is gone from storage too
+            NonceManager again(address, provider, db);
+            again.sync(8);
+            REQUIRE(again.pending().size() == 2);
+            Error e4;
+            REQUIRE(again.next(e4) == 8);
+        }
+    }
+}
@@ -0,0 +1,41 @@
+#include "../src/libs/catch2/catch_amalgamated.hpp"
+#include "../include/web3cpp/Storage.h"
+#include <iostream>
+#include <fstream>
+#include <vector>
+
+using namespace std;
+using Catch::Matchers::Equals;
+
+namespace TStorage
+{
+    TEST_CASE("Test Storage Slot Derivation")
+    {
+        SECTION("Mapping Slots")
+        {
+            dev::Address key("3e8467983ba80734654208b274ebf01264526117");
+            dev::h256 addressSlot = Storage::mappingSlot(key, dev::h256(0));
+            REQUIRE(addressSlot.hex() == "e00e7c22aabe80105ef208bc7a2e2d6fecf9d61c62a95648358b71cfa8cb2381");
+
+            dev::h256 uintSlot = Storage::mappingSlot(dev::h256(1), dev::h256(3));
+            REQUIRE(uintSlot.hex() == "a15bc60c955c405d20d9149c709e2460f1c2d9a497496a7f46004d1772c3054c");
+        }
+
+        SECTION("Array Slots")
+        {
+            dev::h256 first = Storage::arraySlot(dev::h256(2), 0);
+            REQUIRE(first.hex() == "405787fa12a823e0f2b7631cc41b3ba8828b3321ca811111fa75cd3aa3bb5ace");
+
+            dev::h256 sixth = Storage::arraySlot(dev::h256(2), 5, 2);
+            REQUIRE(sixth.hex() == "405787fa12a823e0f2b7631cc41b3ba8828b3321ca811111fa75cd3aa3bb5ad8");
+        }
+
+        SECTION("Slot Ranges")
+        {
+            std::vector<dev::h256> range = Storage::slotRange(dev::h256(10), 3);
+            REQUIRE(range.size() == 3);
+            REQUIRE(range[0] == dev::h256(10));
+            REQUIRE(range[2] == dev::h256(12));
+        }
+    }
+}
@@ -0,0 +1,39 @@
+#include "../src/libs/catch2/catch_amalgamated.hpp"
+#include "../include/web3cpp/TimerService.h"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+using namespace std;
+
+namespace TTimerService
+{
+    TEST_CASE("Test TimerService")
+    {
+        SECTION("Schedule And Cancel")
+        {
+            std::atomic<int> ran{0};
+            TimerService& ts = TimerService::instance();
+            ts.schedule(std::chrono::milliseconds(20), [&ran]{ ran += 1; });
+            TimerService::TimerId cancelled = ts.schedule(std::chrono::milliseconds(20), [&ran]{ ran += 10; });
+            REQUIRE(ts.cancel(cancelled));
+            REQUIRE(!ts.cancel(cancelled));
+            std::this_thread::sleep_for(std::chrono::milliseconds(200));
+            REQUIRE(ran == 1);
+        }
+
+        SECTION("Cancel Waits For Running Task")
+        {
+            std::atomic<int> ran{0};
+            TimerService& ts = TimerService::instance();
+            TimerService::TimerId id = ts.schedule(std::chrono::milliseconds(10), [&ran]{
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                ran += 1;
+            });
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            REQUIRE(!ts.cancel(id));
+            REQUIRE(ran == 1);
+        }
+    }
+}
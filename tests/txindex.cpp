@@ -0,0 +1,100 @@
+#include "../src/libs/catch2/catch_amalgamated.hpp"
+#include "../include/web3cpp/TxIndex.h"
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+namespace TTxIndex
+{
+    // EIP-155 example transaction, from 0x9d8a... to 0x3535...
+    const std::string signedTx = "0xf86c098504a817c800825208943535353535353535353535353535353535353535880de0b6b3a76400008025a028ef61340bd939bc2195fe537567866003e1a15d3c71ff63e1590620aa636276a067cbe9d8997f761aecb703304b3800ccf555c9f3dc64214b297fb1966a3b6d83";
+    const dev::Address owner("0x9d8a62f656a8d1615c1294fd71e9cfb3e4855a4f");
+    const dev::Address receiver("0x3535353535353535353535353535353535353535");
+
+    TxRecord recordAt(uint64_t unixDate) {
+        TxRecord record = TxRecord::fromSignedTx(signedTx);
+        record.unixDate = unixDate;
+        return record;
+    }
+
+    TEST_CASE("Test TxIndex")
+    {
+        SECTION("Range Queries")
+        {
+            Database db = Database::inMemory();
+            TxIndex index(db.partition("tx/"), owner);
+            REQUIRE(index.save(recordAt(1000)));
+
+            REQUIRE(index.byTime(0).size() == 1);
+            REQUIRE(index.byTime(1000, 1000).size() == 1);
+            REQUIRE(index.byTime(1001).empty());
+            REQUIRE(index.byTime(0, 999).empty());
+            REQUIRE(index.byCounterparty(receiver, 900, 1100).size() == 1);
+            REQUIRE(index.byCounterparty(receiver, 1001).empty());
+            REQUIRE(index.byCounterparty(owner).empty());
+            REQUIRE(index.byStatus(TxIndex::Status::Pending).size() == 1);
+            REQUIRE(index.byStatus(TxIndex::Status::Confirmed).empty());
+            REQUIRE(index.byBlock(0).empty());
+        }
+
+        SECTION("Updates Move Index Entries")
+        {
+            Database db = Database::inMemory();
+            Database history = db.partition("tx/");
+            TxIndex index(history, owner);
+            TxRecord record = recordAt(1000);
+            REQUIRE(index.save(record));
+            uint64_t entries = history.getAllKeys().size();
+
+            record.confirmed = true;
+            record.blockNumber = 500;
+            record.unixDate = 2000;
+            REQUIRE(index.save(record));
+            REQUIRE(history.getAllKeys().size() == entries + 1); // + block entry
+            REQUIRE(index.byStatus(TxIndex::Status::Pending).empty());
+            REQUIRE(index.byStatus(TxIndex::Status::Confirmed).size() == 1);
+            REQUIRE(index.byTime(0, 1999).empty());
+            REQUIRE(index.byBlock(500, 500).size() == 1);
+            REQUIRE(index.byBlock(501).empty());
+            REQUIRE(index.byBlock(0, 499).empty());
+
+            TxRecord stored;
+            REQUIRE(index.get(record.key(), stored));
+            REQUIRE(stored.blockNumber == 500);
+            REQUIRE(stored.confirmed);
+        }
+
+        SECTION("Stale Entries Are Skipped")
+        {
+            Database db = Database::inMemory();
+            Database history = db.partition("tx/");
+            TxIndex index(history, owner);
+            TxRecord record = recordAt(1000);
+            REQUIRE(index.save(record));
+            // Rewrite the record alone, leaving its old index entries behind
+            record.unixDate = 3000;
+            REQUIRE(history.putKeyValue(record.key(), record.encode()));
+            REQUIRE(index.byTime(0, 2000).empty());
+        }
+
+        SECTION("Limit And Order")
+        {
+            Database db = Database::inMemory();
+            TxIndex index(db.partition("tx/"), owner);
+            TxRecord record = recordAt(1000);
+            REQUIRE(index.save(record));
+            REQUIRE(index.byTime(0, TxIndex::maxValue, 1, true).size() == 1);
+            REQUIRE(index.byTime(5, 4).empty());
+        }
+
+        SECTION("Batches From Other Databases Are Refused")
+        {
+            Database db = Database::inMemory();
+            Database other = Database::inMemory();
+            TxIndex index(db.partition("tx/"), owner);
+            Database::Batch batch = other.batch();
+            REQUIRE(!index.add(batch, recordAt(1000)));
+        }
+    }
+}
@@ -0,0 +1,105 @@
+#include "../src/libs/catch2/catch_amalgamated.hpp"
+#include "../include/web3cpp/TxPipeline.h"
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Defined in wallet.cpp
+void initializeWallet(std::unique_ptr<Wallet> &wallet, std::unique_ptr<Provider> &provider, const std::string &folderName, bool clearDB);
+
+namespace TTxPipeline
+{
+    const std::string derivPath = "m/44'/60'/0'/0/0";
+    const std::string seed = "corn girl crouch desk duck save hedgehog choose kitchen unveil dragon space";
+
+    // None of these transactions ever reach the send stage, so no network
+    // is needed: they either fail to build or fail to sign.
+    TxPipeline::Request request(const std::string& from, const std::string& to) {
+        TxPipeline::Request req;
+        req.from = from;
+        req.to = to;
+        req.value = 1;
+        req.gasLimit = 21000;
+        req.gasPrice = 40000000000;
+        return req;
+    }
+
+    TEST_CASE("Test TxPipeline")
+    {
+        SECTION("Build Failures Release Nonces")
+        {
+            std::unique_ptr<Wallet> wallet = nullptr;
+            std::unique_ptr<Provider> provider = nullptr;
+            initializeWallet(wallet, provider, "testPipelineWallet", true);
+            Error error;
+            REQUIRE(wallet->loadWallet("password", error));
+            std::string acc = Utils::toLowercaseAddress(
+                wallet->createAccount(derivPath, "password", "pipeline", error, seed));
+            NonceManager& nonces = wallet->getAccountDetails(acc)->nonceManager();
+            nonces.sync(0);
+
+            // Each failure gives its nonce back before the next one is built
+            TxPipeline pipeline(*wallet, "password");
+            for (int i = 0; i < 4; i++) pipeline.submit(request(acc, "not an address"));
+            std::vector<TxPipeline::Result> results = pipeline.wait();
+            REQUIRE(results.size() == 4);
+            for (uint64_t i = 0; i < results.size(); i++) {
+                REQUIRE(results[i].id == i);
+                REQUIRE(results[i].errorCode == 11);
+                REQUIRE(results[i].nonce == 0);
+                REQUIRE(results[i].hash.empty());
+            }
+            REQUIRE(nonces.pending().empty());
+            REQUIRE(nonces.peek() == 0);
+        }
+
+        SECTION("Sign Failures Release Nonces In Order")
+        {
+            std::unique_ptr<Wallet> wallet = nullptr;
+            std::unique_ptr<Provider> provider = nullptr;
+            initializeWallet(wallet, provider, "testPipelineWallet", true);
+            Error error;
+            REQUIRE(wallet->loadWallet("password", error));
+            std::string acc = Utils::toLowercaseAddress(
+                wallet->createAccount(derivPath, "password", "pipeline", error, seed));
+            NonceManager& nonces = wallet->getAccountDetails(acc)->nonceManager();
+            nonces.sync(7);
+
+            // Build failures are mixed with sign failures, which are released
+            // concurrently by the signers while new nonces are handed out
+            TxPipeline::Options opts;
+            opts.signers = 4;
+            TxPipeline pipeline(*wallet, "wrongpassword", opts);
+            const uint64_t count = 32;
+            for (uint64_t i = 0; i < count; i++) {
+                REQUIRE(pipeline.submit(request(acc, (i % 3 == 0) ? "not an address" : acc)) == i);
+            }
+            std::vector<TxPipeline::Result> results = pipeline.wait();
+            REQUIRE(results.size() == count);
+            uint64_t signErrorCode = 0;
+            for (uint64_t i = 0; i < count; i++) {
+                REQUIRE(results[i].id == i);
+                REQUIRE(results[i].from == acc);
+                REQUIRE(results[i].nonce >= 7);
+                REQUIRE(results[i].nonce < 7 + count);
+                REQUIRE(results[i].errorCode != 0);
+                if (i % 3 == 0) {
+                    REQUIRE(results[i].errorCode == 11);
+                } else {
+                    if (signErrorCode == 0) signErrorCode = results[i].errorCode;
+                    REQUIRE(results[i].errorCode == signErrorCode);
+                }
+            }
+
+            // Every nonce was given back, without leaving any gaps behind
+            Error nextErr;
+            REQUIRE(nonces.pending().empty());
+            REQUIRE(nonces.peek() == 7);
+            REQUIRE(nonces.next(nextErr) == 7);
+        }
+    }
+}
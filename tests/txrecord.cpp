@@ -0,0 +1,86 @@
+#include "../src/libs/catch2/catch_amalgamated.hpp"
+#include "../include/web3cpp/TxRecord.h"
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+namespace TTxRecord
+{
+    // EIP-155 example transaction
+    const std::string signedTx = "0xf86c098504a817c800825208943535353535353535353535353535353535353535880de0b6b3a76400008025a028ef61340bd939bc2195fe537567866003e1a15d3c71ff63e1590620aa636276a067cbe9d8997f761aecb703304b3800ccf555c9f3dc64214b297fb1966a3b6d83";
+    const std::string sender = "0x9d8a62f656a8d1615c1294fd71e9cfb3e4855a4f";
+
+    TEST_CASE("Test TxRecord")
+    {
+        SECTION("Encode And Decode")
+        {
+            TxRecord record = TxRecord::fromSignedTx(signedTx);
+            record.blockNumber = 1234;
+            record.confirmed = true;
+            REQUIRE(record.from == dev::Address(sender));
+
+            std::string stored = record.encode();
+            REQUIRE(!TxRecord::isLegacy(stored));
+            TxRecord decoded;
+            REQUIRE(TxRecord::fromStored(stored, decoded));
+            REQUIRE(decoded.raw == record.raw);
+            REQUIRE(decoded.from == record.from);
+            REQUIRE(decoded.unixDate == record.unixDate);
+            REQUIRE(decoded.blockNumber == 1234);
+            REQUIRE(decoded.confirmed);
+            REQUIRE(!decoded.invalid);
+            REQUIRE(decoded.key() == record.key());
+        }
+
+        SECTION("Unsigned Sender Is Kept Empty")
+        {
+            TxRecord record = TxRecord::fromSignedTx(signedTx);
+            record.from = dev::Address();
+            TxRecord decoded;
+            REQUIRE(TxRecord::fromStored(record.encode(), decoded));
+            REQUIRE(!decoded.from);
+            REQUIRE(decoded.toJson()["from"] == "<unsigned>");
+        }
+
+        SECTION("JSON Matches Legacy Fields")
+        {
+            TxRecord record = TxRecord::fromSignedTx(signedTx);
+            json tx = record.toJson();
+            REQUIRE(tx["type"] == "message");
+            REQUIRE(tx["to"] == "3535353535353535353535353535353535353535");
+            REQUIRE(tx["from"] == sender.substr(2));
+            REQUIRE(tx["nonce"] == "9");
+            REQUIRE(tx["gas"] == "21000");
+            REQUIRE(tx["hash"] == record.key());
+            REQUIRE(tx["unixDate"] == record.unixDate);
+            REQUIRE(tx["signature"] == signedTx.substr(2));
+            REQUIRE(!tx.contains("blockNumber"));
+        }
+
+        SECTION("Legacy JSON Records")
+        {
+            TxRecord record = TxRecord::fromSignedTx(signedTx);
+            record.invalid = true;
+            std::string legacy = record.toJson().dump();
+            REQUIRE(TxRecord::isLegacy(legacy));
+            TxRecord converted;
+            REQUIRE(TxRecord::fromStored(legacy, converted));
+            REQUIRE(converted.raw == record.raw);
+            REQUIRE(converted.from == record.from);
+            REQUIRE(converted.unixDate == record.unixDate);
+            REQUIRE(converted.invalid);
+            REQUIRE(converted.encode().size() < legacy.size());
+        }
+
+        SECTION("Invalid Records")
+        {
+            TxRecord record;
+            REQUIRE(!TxRecord::fromStored("", record));
+            REQUIRE(!TxRecord::fromStored("{not json", record));
+            REQUIRE(!TxRecord::fromStored("{\"from\":\"<unsigned>\"}", record));
+            REQUIRE(!TxRecord::fromStored("\xc2\x01\x02", record));
+            REQUIRE_THROWS(TxRecord::fromSignedTx("0x1234"));
+        }
+    }
+}
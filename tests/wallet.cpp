@@ -123,6 +123,97 @@ namespace TWallet
 
         }
 
+        SECTION("Signing Session Cache")
+        {
+            std::unique_ptr<Wallet> wallet = nullptr;
+            std::unique_ptr<Provider> provider = nullptr;
+            initializeWallet(wallet, provider, "testWallet", true);
+            Error error;
+            bool loaded = wallet->loadWallet("password", error);
+            REQUIRE(loaded == true);
+
+            Error badErr, okErr;
+            REQUIRE(!wallet->unlockSession("wrongpassword", 60, badErr));
+            REQUIRE(wallet->unlockSession("password", 60, okErr));
+            REQUIRE(wallet->isSessionUnlocked());
+
+            std::string acc = wallet->getAccounts().at(0);
+            std::string sig1 = wallet->sign("Test Message", acc, "password");
+            std::string sig2 = wallet->sign("Test Message", acc, "password");
+            REQUIRE(sig1 == sig2);
+            REQUIRE(wallet->sessionStats().first == 1);   // hits
+            REQUIRE(wallet->sessionStats().second == 1);  // misses
+
+            // A cached key must not be served for the wrong password
+            std::string sig3 = wallet->sign("Test Message", acc, "wrongpassword");
+            REQUIRE(!Utils::isHexStrict(sig3));
+
+            wallet->clearPassword();
+            REQUIRE(!wallet->isSessionUnlocked());
+            REQUIRE(wallet->sessionKeyCount() == 0);
+        }
+
+        SECTION("Session Keys Expire Without Use")
+        {
+            std::unique_ptr<Wallet> wallet = nullptr;
+            std::unique_ptr<Provider> provider = nullptr;
+            initializeWallet(wallet, provider, "testWallet", true);
+            Error error;
+            bool loaded = wallet->loadWallet("password", error);
+            REQUIRE(loaded == true);
+
+            Error okErr;
+            REQUIRE(wallet->unlockSession("password", 1, okErr));
+            std::string acc = wallet->getAccounts().at(0);
+            wallet->sign("Test Message", acc, "password");
+            REQUIRE(wallet->sessionKeyCount() == 1);
+
+            // The key is wiped by its timer, no lookup needed
+            std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+            REQUIRE(wallet->sessionKeyCount() == 0);
+            REQUIRE(wallet->isSessionUnlocked());
+        }
+
+        SECTION("Batch Signing")
+        {
+            std::unique_ptr<Wallet> wallet = nullptr;
+            std::unique_ptr<Provider> provider = nullptr;
+            initializeWallet(wallet, provider, "testWallet", true);
+            Error error;
+            bool loaded = wallet->loadWallet("password", error);
+            REQUIRE(loaded == true);
+            std::string acc = wallet->getAccounts().at(0);
+
+            std::vector<std::pair<std::string, std::string>> msgs;
+            for (int i = 0; i < 8; i++) msgs.emplace_back(acc, "Message " + std::to_string(i));
+            Error msgErr;
+            std::vector<std::string> sigs = wallet->signMessages(msgs, "password", msgErr);
+            REQUIRE(msgErr.getCode() == 0);
+            REQUIRE(sigs.size() == msgs.size());
+            for (int i = 0; i < 8; i++) {
+                REQUIRE(sigs[i] == wallet->sign(msgs[i].second, acc, "password"));
+            }
+
+            std::vector<dev::eth::TransactionSkeleton> txs;
+            for (uint64_t nonce = 0; nonce < 4; nonce++) {
+                Error buildErr;
+                txs.push_back(wallet->buildTransaction(
+                    acc, acc, 1, 21000, 40000000000, "", nonce, buildErr));
+            }
+            Error txErr;
+            std::vector<std::string> signedTxs = wallet->signTransactions(txs, "password", txErr);
+            REQUIRE(txErr.getCode() == 0);
+            for (uint64_t i = 0; i < txs.size(); i++) {
+                Error signErr;
+                REQUIRE(signedTxs[i] == wallet->signTransaction(txs[i], "password", signErr));
+            }
+
+            Error badErr;
+            std::vector<std::string> bad = wallet->signMessages(msgs, "wrongpassword", badErr);
+            REQUIRE(badErr.getCode() != 0);
+            REQUIRE(bad[0].empty());
+        }
+
         SECTION("Test Transaction")
         {
             std::unique_ptr<Wallet> wallet = nullptr;
@@ -163,6 +254,8 @@ namespace TWallet
                 BigNumber gasLimit = 21000;       // 21000 wei
                 BigNumber gasPrice = 40000000000; // 40 gwei = 40000000000 wei
                 std::string dataHex = "";
+                Error nonceErr;
+                wallet->refreshNonces(nonceErr).get();
                 int nonce = a->nonce();
                 dev::eth::TransactionSkeleton txSkel = wallet->buildTransaction(
                     from, to, value, gasLimit, gasPrice, dataHex, nonce, buildErr);